@@ -23,10 +23,13 @@
 #ifndef LIBGAMBIT_BEHAV_H
 #define LIBGAMBIT_BEHAV_H
 
+#include <vector>
 #include "game.h"
 
 namespace Gambit {
 
+class GameTreeIndex;
+
 ///
 /// MixedBehavProfile<T> implements a randomized behavior profile on
 /// an extensive game.
@@ -48,6 +51,14 @@ protected:
   mutable DVector<T> m_actionValues;   // aka conditional payoffs
   mutable DVector<T> m_gripe;
 
+  // structures for updating cached data after changes at a few
+  // information sets, numbered as in the tree index
+  mutable Array<T> m_actionProbs, m_infosetProbs;
+  mutable std::vector<int> m_changedInfosets;
+  mutable std::vector<char> m_infosetMarks, m_nodeMarks;
+  // the subvector containing each entry, built on demand
+  Array<int> m_entrySubvectors;
+
   const T &ActionValue(const GameAction &act) const 
     { return m_actionValues(act->GetInfoset()->GetPlayer()->GetNumber(),
 			    act->GetInfoset()->GetNumber(),
@@ -59,11 +70,30 @@ protected:
   
   /// @name Auxiliary functions for computation of interesting values
   //@{
-  void GetPayoff(GameTreeNodeRep *, const T &, int, T &) const;
-  
-  void ComputeSolutionDataPass2(const GameNode &node) const;
-  void ComputeSolutionDataPass1(const GameNode &node) const;
+  /// Returns the flattened view of the game tree
+  const GameTreeIndex &GetTreeIndex(void) const;
+  /// Sets p_probs to the probability of each action, in the order of
+  /// the actions in the tree index
+  void GetActionProbs(const GameTreeIndex &, Array<T> &p_probs) const;
+
+  void ComputeSolutionDataPass2(const GameTreeIndex &, const Array<T> &p_probs,
+				const Array<T> &p_infosetProbs) const;
+  void ComputeSolutionDataPass1(const GameTreeIndex &,
+				const Array<T> &p_probs) const;
   void ComputeSolutionData(void) const;
+  /// Recomputes only the data depending on the probabilities at the
+  /// changed information sets; returns false if this is not possible
+  bool UpdateSolutionData(const GameTreeIndex &) const;
+  /// Computes the value and regrets at an information set
+  void ComputeInfosetValues(const GameTreeIndex &, int p_infoset) const;
+  /// Records a change to the probabilities in a subvector
+  void InvalidateSubvector(int p_subvector);
+  /// Records a change to the probability at an entry
+  void InvalidateEntry(int p_index);
+  /// Computes the value of a best response and the payoff of the
+  /// profile for each player, into vectors indexed by player
+  void ComputeBestResponses(int p_threads, Vector<T> &p_values,
+			    Vector<T> &p_payoffs) const;
   //@}
 
   /// @name Converting mixed strategies to behavior
@@ -112,11 +142,13 @@ public:
   const T &operator()(int a, int b, int c) const
     { return DVector<T>::operator()(a, b, c); }
   T &operator()(int a, int b, int c) 
-    { Invalidate();  return DVector<T>::operator()(a, b, c); }
+    { if (m_cacheValid)  InvalidateSubvector(this->dvidx[a] + b - 1);
+      return DVector<T>::operator()(a, b, c); }
   const T &operator[](int a) const
     { return Array<T>::operator[](a); }
   T &operator[](int a)
-    { Invalidate();  return Array<T>::operator[](a); }
+    { if (m_cacheValid)  InvalidateEntry(a);
+      return Array<T>::operator[](a); }
 
   MixedBehavProfile<T> &operator+=(const MixedBehavProfile<T> &x)
     { Invalidate();  DVector<T>::operator+=(x);  return *this; }
@@ -130,7 +162,10 @@ public:
 
   /// @name Initialization, validation
   //@{
-  /// Force recomputation of stored quantities
+  /// Force recomputation of stored quantities.  Changes made through
+  /// the operators above are tracked by information set, and only the
+  /// quantities depending on them are recomputed; this must be called
+  /// after changing the probabilities by other means.
   void Invalidate(void) const { m_cacheValid = false; }
   /// Set the profile to the centroid
   void Centroid(void);
@@ -149,6 +184,16 @@ public:
   //@{
   T GetPayoff(int p_player) const;
   T GetLiapValue(bool p_definedOnly = false) const;
+  /// Returns the payoff to each player of the best response to the
+  /// profile, over all actions in the game.  Each player takes one
+  /// pass over the tree, and the players are computed concurrently
+  /// on the given number of threads (one per processor if zero).
+  /// The game is assumed to have perfect recall.
+  Vector<T> GetBestResponseValues(int p_threads = 1) const;
+  /// Returns the sum over players of the gain from playing a best
+  /// response to the profile, which is zero exactly at a Nash
+  /// equilibrium
+  T GetExploitability(int p_threads = 1) const;
 
   const T &GetRealizProb(const GameNode &node) const;
   const T &GetBeliefProb(const GameNode &node) const;
@@ -20,13 +20,14 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
-#include <cstdlib>
 #include <cctype>
+#include <climits>
 #include <iostream>
 #include <sstream>
 #include <map>
 
 #include "libgambit.h"
+#include "snapshot.h"
 
 namespace {
 // This anonymous namespace encapsulates the file-parsing code
@@ -43,41 +44,103 @@ typedef enum {
 //! including the nonsignificance of whitespace and the possibility of
 //! escaped-quotes within text labels.
 //!
+//! The parser works on a buffer holding the entire file, which may be
+//! read in from a stream or supplied directly by the caller (for
+//! example, a memory-mapped file).  The buffer is not copied; number
+//! tokens are converted in place by GetNumber() and GetInteger().
+//!
 class GameParserState {
 private:
-  std::istream &m_file;
-
+  const char *m_current, *m_end;
   int m_currentLine;
+  const char *m_lineStart;
+
   GameFileToken m_lastToken;
+  const char *m_tokenStart, *m_tokenEnd;
+  int m_tokenLine, m_tokenColumn;
   std::string m_lastText;
 
+  void SkipDigits(void)
+  { while (m_current < m_end && isdigit(*m_current))  m_current++; }
+
 public:
-  GameParserState(std::istream &p_file) : 
-    m_file(p_file), m_currentLine(1) { }
+  /// Parses the text in [p_begin, p_end)
+  GameParserState(const char *p_begin, const char *p_end)
+    : m_current(p_begin), m_end(p_end), m_currentLine(1),
+      m_lineStart(p_begin), m_lastToken(TOKEN_EOF),
+      m_tokenStart(p_begin), m_tokenEnd(p_begin),
+      m_tokenLine(1), m_tokenColumn(1) { }
 
   GameFileToken GetNextToken(void);
   GameFileToken GetCurrentToken(void) const { return m_lastToken; }
-  int GetCurrentLine(void) const { return m_currentLine; }
+  int GetCurrentLine(void) const { return m_tokenLine; }
+  int GetCurrentColumn(void) const { return m_tokenColumn; }
+  /// Returns the contents of the last text or symbol token
   const std::string &GetLastText(void) const { return m_lastText; }
+  /// Returns the value of the last number token
+  Gambit::Number GetNumber(void) const
+  { return Gambit::Number(m_tokenStart, m_tokenEnd); }
+  /// Returns the value of the last number token, which must be an integer
+  int GetInteger(void) const;
+  /// Returns the last number token as it appears in the file
+  std::string GetNumberText(void) const
+  { return std::string(m_tokenStart, m_tokenEnd); }
+
+  /// Returns an exception describing an error at the last token read
+  InvalidFileException Error(const std::string &p_message) const;
 };  
 
-GameFileToken GameParserState::GetNextToken(void)
+int GameParserState::GetInteger(void) const
 {
-  char c = ' '; 
-  if (m_file.eof()) {
-    return (m_lastToken = TOKEN_EOF);
+  const char *ch = m_tokenStart;
+  bool negative = (ch < m_tokenEnd && *ch == '-');
+  if (ch < m_tokenEnd && (*ch == '-' || *ch == '+'))  ch++;
+  if (ch == m_tokenEnd) {
+    throw Error("expecting an integer");
   }
 
-  while (isspace(c)) {
-    m_file.get(c);
-    if (!m_file.good()) {
-      return (m_lastToken = TOKEN_EOF);
-    } 
-    else if (c == '\n') {
+  int value = 0;
+  for (; ch < m_tokenEnd; ch++) {
+    if (!isdigit(*ch) || value > (INT_MAX - 9) / 10) {
+      throw Error("expecting an integer");
+    }
+    value = 10 * value + (*ch - '0');
+  }
+  return (negative) ? -value : value;
+}
+
+InvalidFileException 
+GameParserState::Error(const std::string &p_message) const
+{
+  return InvalidFileException("Parse error at line " +
+			      lexical_cast<std::string>(m_tokenLine) +
+			      ", column " + 
+			      lexical_cast<std::string>(m_tokenColumn) +
+			      ": " + p_message);
+}
+
+GameFileToken GameParserState::GetNextToken(void)
+{
+  while (m_current < m_end && isspace(*m_current)) {
+    if (*m_current == '\n') {
       m_currentLine++;
+      m_lineStart = m_current + 1;
     }
+    m_current++;
   }
 
+  m_tokenStart = m_current;
+  m_tokenLine = m_currentLine;
+  m_tokenColumn = m_current - m_lineStart + 1;
+
+  if (m_current == m_end) {
+    m_tokenEnd = m_current;
+    return (m_lastToken = TOKEN_EOF);
+  }
+
+  char c = *m_current++;
+  m_tokenEnd = m_current;
+
   if (c == '{') {
     return (m_lastToken = TOKEN_LBRACE);
   }
@@ -87,146 +150,67 @@ GameFileToken GameParserState::GetNextToken(void)
   else if (c == ',') {
     return (m_lastToken = TOKEN_COMMA);
   }
-  else if (isdigit(c) || c == '-' || c == '+') {
-    std::string buf;
-    buf += c;
-    m_file.get(c);
-
-    while (!m_file.eof() && m_file.good() && isdigit(c)) {
-      buf += c;
-      m_file.get(c);
+  else if (isdigit(c) || c == '-' || c == '+' || c == '.') {
+    // A number is a string of digits, followed either by a '/' and
+    // a denominator, or by a fractional part and/or an exponent
+    SkipDigits();
+    if (c != '.' && m_current < m_end && *m_current == '/') {
+      m_current++;
+      SkipDigits();
     }
-    
-    if (m_file.eof() || !m_file.good()) {
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
-    }      
-
-    if (c == '.') {
-      buf += c;
-      m_file.get(c);
-      while (isdigit(c)) {
-      	buf += c;
-      	m_file.get(c);
+    else {
+      if (c != '.' && m_current < m_end && *m_current == '.') {
+	m_current++;
+	SkipDigits();
       }
-
-      if (c == 'e' || c == 'E') {
-	buf += c;
-	m_file.get(c);
-	if (c == '+' && c == '-' && !isdigit(c)) {
-	  throw InvalidFileException();
-	}
-	buf += c;
-	m_file.get(c);
-	while (isdigit(c)) {
-	  buf += c;
-	  m_file.get(c);
+      if (m_current < m_end && (*m_current == 'e' || *m_current == 'E')) {
+	m_current++;
+	if (m_current < m_end && (*m_current == '+' || *m_current == '-')) {
+	  m_current++;
 	}
+	SkipDigits();
       }
-
-      m_file.unget();
-      m_lastText = buf;
-
-      return (m_lastToken = TOKEN_NUMBER);
-    }
-    else if (c == '/') {
-      buf += c;
-      m_file.get(c);
-      while (isdigit(c)) {
-      	buf += c;
-      	m_file.get(c);
-      }
-      m_file.unget();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
-    }
-    else if (c == 'e' || c == 'E') {
-      buf += c;
-      m_file.get(c);
-      if (c == '+' && c == '-' && !isdigit(c)) {
-	throw InvalidFileException();
-      }
-      buf += c;
-      m_file.get(c);
-      while (isdigit(c)) {
-	buf += c;
-	m_file.get(c);
-      }
-      m_file.unget();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
-    }
-    else {
-      m_file.unget();
-      m_lastText = buf;
-      return (m_lastToken = TOKEN_NUMBER);
     }
-  }
-  else if (c == '.') {
-    std::string buf;
-    buf += c;
-    m_file.get(c);
-    
-    while (isdigit(c)) {
-      buf += c;
-      m_file.get(c);
-    }
-    m_file.unget();
-    m_lastText = buf;
+    m_tokenEnd = m_current;
     return (m_lastToken = TOKEN_NUMBER);
   }
-
   else if (c == '"') {
     // We need to do a little magic here, since escaped quotes inside
     // the string are treated as quotes (not end-of-string)
-    m_file.unget();
-    char a;
-  
-    m_lastText = "";
-  
-    do  {
-      m_file.get(a);
-      if (isspace(a) && a=='\n') {
-        m_currentLine++;
+    m_lastText.clear();
+    bool lastslash = false;
+
+    while (m_current < m_end && (*m_current != '"' || lastslash)) {
+      char a = *m_current++;
+      if (a == '\n') {
+	m_currentLine++;
+	m_lineStart = m_current;
       }
-    }  while (isspace(a));
-
-    if (a == '\"')  {
-      bool lastslash = false;
-
-      m_file.get(a);
-      while  (a != '\"' || lastslash)  {
-      	if (lastslash && a == '"')  
-      	  m_lastText += '"';
-      	else if (lastslash)  {
-      	  m_lastText += '\\';
-      	  m_lastText += a;
-      	}
-      	else if (a != '\\')
-      	  m_lastText += a;
-      	
-      	lastslash = (a == '\\');
-      	m_file.get(a);
+
+      if (lastslash && a == '"')  
+	m_lastText += '"';
+      else if (lastslash)  {
+	m_lastText += '\\';
+	m_lastText += a;
       }
-    }
-    else  {
-      do  {
-      	m_lastText += a;
-      	m_file.get(a);
-        if (isspace(a) && a=='\n') {
-          m_currentLine++;
-        }
-      }  while (!isspace(a));
+      else if (a != '\\')
+	m_lastText += a;
+      
+      lastslash = (a == '\\');
     }
 
+    if (m_current == m_end) {
+      throw Error("unterminated text string");
+    }
+    m_tokenEnd = ++m_current;
     return (m_lastToken = TOKEN_TEXT);
   }
 
-  m_lastText = "";
-  while (!isspace(c) && !m_file.eof()) {
-    m_lastText += c;
-    m_file.get(c);
+  while (m_current < m_end && !isspace(*m_current)) {
+    m_current++;
   }
+  m_tokenEnd = m_current;
+  m_lastText.assign(m_tokenStart, m_tokenEnd);
   return (m_lastToken = TOKEN_SYMBOL);
 }
 
@@ -349,7 +333,7 @@ std::string TableFileGame::GetStrategy(int p_player, int p_strategy) const
 void ReadPlayers(GameParserState &p_state, TableFileGame &p_data)
 {
   if (p_state.GetNextToken() != TOKEN_LBRACE) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting '{' before list of players");
   }
 
   while (p_state.GetNextToken() == TOKEN_TEXT) {
@@ -357,7 +341,7 @@ void ReadPlayers(GameParserState &p_state, TableFileGame &p_data)
   }
 
   if (p_state.GetCurrentToken() != TOKEN_RBRACE) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting '}' after list of players");
   }
 
   p_state.GetNextToken();
@@ -366,7 +350,7 @@ void ReadPlayers(GameParserState &p_state, TableFileGame &p_data)
 void ReadStrategies(GameParserState &p_state, TableFileGame &p_data)
 {
   if (p_state.GetCurrentToken() != TOKEN_LBRACE) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting '{' before list of strategies");
   }
   p_state.GetNextToken();
 
@@ -376,7 +360,7 @@ void ReadStrategies(GameParserState &p_state, TableFileGame &p_data)
     while (p_state.GetCurrentToken() == TOKEN_LBRACE) {
       if (!player) {
 	// Not enough players for number of strategy entries
-	throw InvalidFileException();
+	throw p_state.Error("more strategy lists than players");
       }
 
       while (p_state.GetNextToken() == TOKEN_TEXT) {
@@ -384,7 +368,7 @@ void ReadStrategies(GameParserState &p_state, TableFileGame &p_data)
       }
 
       if (p_state.GetCurrentToken() != TOKEN_RBRACE) {
-	throw InvalidFileException();
+	throw p_state.Error("expecting '}' after list of strategies");
       }
 
       p_state.GetNextToken();
@@ -393,11 +377,11 @@ void ReadStrategies(GameParserState &p_state, TableFileGame &p_data)
 
     if (player) {
       // Players with strategies undefined
-      throw InvalidFileException();
+      throw p_state.Error("fewer strategy lists than players");
     }
 
     if (p_state.GetCurrentToken() != TOKEN_RBRACE) {
-      throw InvalidFileException();
+      throw p_state.Error("expecting '}' after strategy lists");
     }
 
     p_state.GetNextToken();
@@ -408,10 +392,11 @@ void ReadStrategies(GameParserState &p_state, TableFileGame &p_data)
     while (p_state.GetCurrentToken() == TOKEN_NUMBER) {
       if (!player) {
 	// Not enough players for number of strategy entries
-	throw InvalidFileException();
+	throw p_state.Error("more strategy counts than players");
       }
 
-      for (int st = 1; st <= atoi(p_state.GetLastText().c_str()); st++) {
+      int numStrats = p_state.GetInteger();
+      for (int st = 1; st <= numStrats; st++) {
 	player->m_strategies.Append(lexical_cast<std::string>(st));
       }
 
@@ -420,34 +405,34 @@ void ReadStrategies(GameParserState &p_state, TableFileGame &p_data)
     }
 
     if (p_state.GetCurrentToken() != TOKEN_RBRACE) {
-      throw InvalidFileException();
+      throw p_state.Error("expecting '}' after strategy counts");
     }
 
     if (player) {
       // Players with strategies undefined
-      throw InvalidFileException();
+      throw p_state.Error("fewer strategy counts than players");
     }
 
     p_state.GetNextToken();
   }
   else {
-    throw InvalidFileException();
+    throw p_state.Error("expecting strategy lists or counts");
   }
 }
 
 void ParseNfgHeader(GameParserState &p_state, TableFileGame &p_data)
 {
   if (p_state.GetNextToken() != TOKEN_NUMBER ||
-      p_state.GetLastText() != "1") {
-    throw InvalidFileException();
+      p_state.GetNumberText() != "1") {
+    throw p_state.Error("expecting file format version 1");
   }
 
   if (p_state.GetNextToken() != TOKEN_SYMBOL || 
       (p_state.GetLastText() != "D" && p_state.GetLastText() != "R")) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting 'D' or 'R'");
   }
   if (p_state.GetNextToken() != TOKEN_TEXT) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting game title");
   }
   p_data.m_title = p_state.GetLastText();
 
@@ -471,7 +456,7 @@ void ReadOutcomeList(GameParserState &p_parser, GameRep *p_nfg)
   }
 
   if (p_parser.GetCurrentToken() != TOKEN_LBRACE) {
-    throw InvalidFileException();
+    throw p_parser.Error("expecting '{' before outcome");
   }
 
   int nOutcomes = 0;
@@ -481,7 +466,7 @@ void ReadOutcomeList(GameParserState &p_parser, GameRep *p_nfg)
     int pl = 1;
     
     if (p_parser.GetNextToken() != TOKEN_TEXT) {
-      throw InvalidFileException();
+      throw p_parser.Error("expecting outcome label");
     }
 
     GameOutcome outcome;
@@ -496,29 +481,28 @@ void ReadOutcomeList(GameParserState &p_parser, GameRep *p_nfg)
     outcome->SetLabel(p_parser.GetLastText());
     p_parser.GetNextToken();
 
-    try {
-      while (p_parser.GetCurrentToken() == TOKEN_NUMBER) {
-	outcome->SetPayoff(pl++, p_parser.GetLastText());
-	if (p_parser.GetNextToken() == TOKEN_COMMA) {
-	  p_parser.GetNextToken();
-	}
+    while (p_parser.GetCurrentToken() == TOKEN_NUMBER) {
+      if (pl > p_nfg->NumPlayers()) {
+	throw p_parser.Error("more payoffs than players");
+      }
+      outcome->SetPayoff(pl++, p_parser.GetNumber());
+      if (p_parser.GetNextToken() == TOKEN_COMMA) {
+	p_parser.GetNextToken();
       }
-    }
-    catch (IndexException &) {
-      // This would be triggered by too many payoffs
-      throw InvalidFileException();
     }
 
-    if (pl <= p_nfg->NumPlayers() ||
-	p_parser.GetCurrentToken() != TOKEN_RBRACE) {
-      throw InvalidFileException();
+    if (pl <= p_nfg->NumPlayers()) {
+      throw p_parser.Error("fewer payoffs than players");
+    }
+    if (p_parser.GetCurrentToken() != TOKEN_RBRACE) {
+      throw p_parser.Error("expecting '}' after outcome payoffs");
     }
 
     p_parser.GetNextToken();
   }
 
   if (p_parser.GetCurrentToken() != TOKEN_RBRACE) {
-    throw InvalidFileException();
+    throw p_parser.Error("expecting '}' after list of outcomes");
   }
   p_parser.GetNextToken();
 }
@@ -531,10 +515,13 @@ void ParseOutcomeBody(GameParserState &p_parser, GameRep *p_nfg)
 
   while (p_parser.GetCurrentToken() != TOKEN_EOF) {
     if (p_parser.GetCurrentToken() != TOKEN_NUMBER) {
-      throw InvalidFileException();
+      throw p_parser.Error("expecting outcome number");
+    }
+    if (iter.AtEnd()) {
+      throw p_parser.Error("more outcome entries than contingencies");
     }
 
-    int outcomeId = atoi(p_parser.GetLastText().c_str());
+    int outcomeId = p_parser.GetInteger();
     if (outcomeId > 0)  {
       (*iter)->SetOutcome(p_nfg->GetOutcome(outcomeId));
     }
@@ -546,21 +533,33 @@ void ParseOutcomeBody(GameParserState &p_parser, GameRep *p_nfg)
   }
 }
 
+//
+// Payoffs are listed by contingency, with the first player's strategy
+// changing fastest.  This is the order in which the table numbers the
+// outcomes it creates for each contingency, so each payoff is stored
+// directly in its outcome without going through a profile.
+//
 void ParsePayoffBody(GameParserState &p_parser, GameRep *p_nfg)
 {
-  StrategyIterator iter(StrategySupport(static_cast<GameRep *>(p_nfg)));
-  int pl = 1;
+  int numPlayers = p_nfg->NumPlayers(), numOutcomes = p_nfg->NumOutcomes();
+  int cont = 1, pl = 1;
+  GameOutcomeRep *outcome = 0;
 
   while (p_parser.GetCurrentToken() != TOKEN_EOF) {
-    if (p_parser.GetCurrentToken() == TOKEN_NUMBER) {
-      (*iter)->GetOutcome()->SetPayoff(pl, p_parser.GetLastText());
+    if (p_parser.GetCurrentToken() != TOKEN_NUMBER) {
+      throw p_parser.Error("expecting payoff");
     }
-    else {
-      throw InvalidFileException();
+
+    if (pl == 1) {
+      if (cont > numOutcomes) {
+	throw p_parser.Error("more payoffs than contingencies");
+      }
+      outcome = p_nfg->GetOutcome(cont);
     }
+    outcome->SetPayoff(pl, p_parser.GetNumber());
 
-    if (++pl > p_nfg->NumPlayers()) {
-      iter++;
+    if (++pl > numPlayers) {
+      cont++;
       pl = 1;
     }
     p_parser.GetNextToken();
@@ -596,7 +595,7 @@ Game BuildNfg(GameParserState &p_parser, TableFileGame &p_data)
     ParsePayoffBody(p_parser, nfg);
   }
   else {
-    throw InvalidFileException();
+    throw p_parser.Error("expecting outcome list or payoffs");
   }
 
   return game;
@@ -622,7 +621,7 @@ void ReadPlayers(GameParserState &p_state,
 		 Game p_game, TreeData &p_treeData)
 {
   if (p_state.GetNextToken() != TOKEN_LBRACE) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting '{' before list of players");
   }
 
   while (p_state.GetNextToken() == TOKEN_TEXT) {
@@ -631,7 +630,7 @@ void ReadPlayers(GameParserState &p_state,
   }
 
   if (p_state.GetCurrentToken() != TOKEN_RBRACE) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting '}' after list of players");
   }
 }
 
@@ -648,10 +647,10 @@ void ParseOutcome(GameParserState &p_state,
 		  GameNode p_node)
 {
   if (p_state.GetCurrentToken() != TOKEN_NUMBER) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting outcome number");
   }
 
-  int outcomeId = atoi(p_state.GetLastText().c_str());
+  int outcomeId = p_state.GetInteger();
   p_state.GetNextToken();
 
   if (p_state.GetCurrentToken() == TOKEN_TEXT) {
@@ -669,16 +668,16 @@ void ParseOutcome(GameParserState &p_state,
     p_node->SetOutcome(outcome);
 
     if (p_state.GetNextToken() != TOKEN_LBRACE) {
-      throw InvalidFileException();
+      throw p_state.Error("expecting '{' before outcome payoffs");
     }
     p_state.GetNextToken();
 
     for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
       if (p_state.GetCurrentToken() == TOKEN_NUMBER) {
-	outcome->SetPayoff(pl, p_state.GetLastText());
+	outcome->SetPayoff(pl, p_state.GetNumber());
       }
       else {
-	throw InvalidFileException();
+	throw p_state.Error("expecting payoff");
       }
 
       // Commas are optional between payoffs
@@ -688,7 +687,7 @@ void ParseOutcome(GameParserState &p_state,
     }
 
     if (p_state.GetCurrentToken() != TOKEN_RBRACE) {
-      throw InvalidFileException();
+      throw p_state.Error("expecting '}' after outcome payoffs");
     }
     p_state.GetNextToken();
   }
@@ -700,7 +699,7 @@ void ParseOutcome(GameParserState &p_state,
       p_node->SetOutcome(p_treeData.m_outcomeMap[outcomeId]);
     }
     else {
-      throw InvalidFileException();
+      throw p_state.Error("outcome referenced before it is defined");
     }
   }
 }
@@ -718,15 +717,15 @@ void ParseChanceNode(GameParserState &p_state,
 		     Game p_game, GameNode p_node, TreeData &p_treeData)
 {
   if (p_state.GetNextToken() != TOKEN_TEXT) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting node label");
   }
   p_node->SetLabel(p_state.GetLastText());
 
   if (p_state.GetNextToken() != TOKEN_NUMBER) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting information set number");
   }
 
-  int infosetId = atoi(p_state.GetLastText().c_str());
+  int infosetId = p_state.GetInteger();
   GameInfoset infoset;
   if (p_treeData.m_chanceInfosetMap.count(infosetId)) {
     infoset = p_treeData.m_chanceInfosetMap[infosetId];
@@ -740,22 +739,22 @@ void ParseChanceNode(GameParserState &p_state,
     std::string label = p_state.GetLastText();
 
     if (p_state.GetNextToken() != TOKEN_LBRACE) {
-      throw InvalidFileException();
+      throw p_state.Error("expecting '{' before list of actions");
     }
     p_state.GetNextToken();
     do {
       if (p_state.GetCurrentToken() != TOKEN_TEXT) {
-	throw InvalidFileException();
+	throw p_state.Error("expecting action label");
       }
       actions.Append(p_state.GetLastText());
 
       p_state.GetNextToken();
       
       if (p_state.GetCurrentToken() == TOKEN_NUMBER) {
-	probs.Append(p_state.GetLastText());
+	probs.Append(p_state.GetNumberText());
       }
       else {
-	throw InvalidFileException();
+	throw p_state.Error("expecting action probability");
       }
 
       p_state.GetNextToken();
@@ -781,7 +780,7 @@ void ParseChanceNode(GameParserState &p_state,
   }
   else {
     // Referencing an undefined infoset is an error
-    throw InvalidFileException();
+    throw p_state.Error("information set referenced before it is defined");
   }
 
   ParseOutcome(p_state, p_game, p_treeData, p_node);
@@ -795,22 +794,22 @@ void ParsePersonalNode(GameParserState &p_state,
 		       Game p_game, GameNode p_node, TreeData &p_treeData)
 {
   if (p_state.GetNextToken() != TOKEN_TEXT) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting node label");
   }
   p_node->SetLabel(p_state.GetLastText());
 
   if (p_state.GetNextToken() != TOKEN_NUMBER) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting player number");
   }
-  int playerId = atoi(p_state.GetLastText().c_str());
+  int playerId = p_state.GetInteger();
   // This will throw an exception if the player ID is not valid
   GamePlayer player = p_game->GetPlayer(playerId);
   std::map<int, GameInfoset> &infosetMap = p_treeData.m_infosetMap[playerId];
 
   if (p_state.GetNextToken() != TOKEN_NUMBER) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting information set number");
   }
-  int infosetId = atoi(p_state.GetLastText().c_str());
+  int infosetId = p_state.GetInteger();
   GameInfoset infoset;
   if (infosetMap.count(infosetId)) {
     infoset = infosetMap[infosetId];
@@ -824,12 +823,12 @@ void ParsePersonalNode(GameParserState &p_state,
     std::string label = p_state.GetLastText();
 
     if (p_state.GetNextToken() != TOKEN_LBRACE) {
-      throw InvalidFileException();
+      throw p_state.Error("expecting '{' before list of actions");
     }
     p_state.GetNextToken();
     do {
       if (p_state.GetCurrentToken() != TOKEN_TEXT) {
-	throw InvalidFileException();
+	throw p_state.Error("expecting action label");
       }
       actions.Append(p_state.GetLastText());
 
@@ -855,7 +854,7 @@ void ParsePersonalNode(GameParserState &p_state,
   }
   else {
     // Referencing an undefined infoset is an error
-    throw InvalidFileException();
+    throw p_state.Error("information set referenced before it is defined");
   }
 
   ParseOutcome(p_state, p_game, p_treeData, p_node);
@@ -869,7 +868,7 @@ void ParseTerminalNode(GameParserState &p_state,
 		       Game p_game, GameNode p_node, TreeData &p_treeData)
 {
   if (p_state.GetNextToken() != TOKEN_TEXT) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting node label");
   }
   
   p_node->SetLabel(p_state.GetLastText());
@@ -891,23 +890,23 @@ void ParseNode(GameParserState &p_state, Game p_game, GameNode p_node,
     ParseTerminalNode(p_state, p_game, p_node, p_treeData);
   }
   else {
-    throw InvalidFileException();
+    throw p_state.Error("expecting node type 'c', 'p', or 't'");
   }
 }
 
 void ParseEfg(GameParserState &p_state, Game p_game, TreeData &p_treeData)
 {
   if (p_state.GetNextToken() != TOKEN_NUMBER ||
-      p_state.GetLastText() != "2") {
-    throw InvalidFileException();
+      p_state.GetNumberText() != "2") {
+    throw p_state.Error("expecting file format version 2");
   }
 
   if (p_state.GetNextToken() != TOKEN_SYMBOL ||
       (p_state.GetLastText() != "D" && p_state.GetLastText() != "R")) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting 'D' or 'R'");
   }
   if (p_state.GetNextToken() != TOKEN_TEXT) {
-    throw InvalidFileException();
+    throw p_state.Error("expecting game title");
   }
   p_game->SetTitle(p_state.GetLastText());
   
@@ -922,43 +921,79 @@ void ParseEfg(GameParserState &p_state, Game p_game, TreeData &p_treeData)
   ParseNode(p_state, p_game, p_game->GetRoot(), p_treeData);
 }
 
-} // end of anonymous namespace
-
-
-namespace Gambit {
-
-//=========================================================================
-//    ReadGame: Global visible function to read an .efg or .nfg file
-//=========================================================================
-
-Game ReadGame(std::istream &p_file) throw (InvalidFileException)
+Game ParseGame(GameParserState &p_parser)
 {
-  GameParserState parser(p_file);
-
   try {
-    if (parser.GetNextToken() != TOKEN_SYMBOL) {
-      throw InvalidFileException();
+    if (p_parser.GetNextToken() != TOKEN_SYMBOL) {
+      throw p_parser.Error("expecting 'NFG' or 'EFG'");
     }
 
-    if (parser.GetLastText() == "NFG") {
+    if (p_parser.GetLastText() == "NFG") {
       TableFileGame data;
-      ParseNfgHeader(parser, data);
-      return BuildNfg(parser, data);
+      ParseNfgHeader(p_parser, data);
+      return BuildNfg(p_parser, data);
     }
-    else if (parser.GetLastText() == "EFG") {
+    else if (p_parser.GetLastText() == "EFG") {
       TreeData treeData;
       Game game = NewTree();
-      ParseEfg(parser, game, treeData);
+      ParseEfg(p_parser, game, treeData);
       game->Canonicalize();
       return game;
     }
     else {
-      throw InvalidFileException();
+      throw p_parser.Error("expecting 'NFG' or 'EFG'");
     }
   }
+  catch (InvalidFileException &) {
+    throw;
+  }
+  catch (std::exception &e) {
+    // Errors raised while building the game, such as invalid payoff
+    // values or out-of-range player numbers, are reported at the
+    // token being processed
+    throw p_parser.Error(e.what());
+  }
   catch (...) {
-    throw InvalidFileException();
+    throw p_parser.Error("invalid entry");
   }
 }
 
+} // end of anonymous namespace
+
+
+namespace Gambit {
+
+//=========================================================================
+//    ReadGame: Global visible function to read an .efg or .nfg file
+//=========================================================================
+
+Game ReadGame(std::istream &p_file) throw (InvalidFileException)
+{
+  // Read directly from the stream buffer in large blocks, rather than
+  // one character at a time through the stream
+  std::string contents;
+  std::streambuf *buffer = p_file.rdbuf();
+  if (buffer) {
+    char block[65536];
+    std::streamsize count;
+    while ((count = buffer->sgetn(block, sizeof(block))) > 0) {
+      contents.append(block, count);
+    }
+  }
+  p_file.setstate(std::ios::eofbit);
+
+  return ReadGame(contents.data(), contents.data() + contents.length());
+}
+
+Game ReadGame(const char *p_begin, const char *p_end)
+  throw (InvalidFileException)
+{
+  if (IsSnapshot(p_begin, p_end)) {
+    return ReadSnapshot(p_begin, p_end);
+  }
+
+  GameParserState parser(p_begin, p_end);
+  return ParseGame(parser);
+}
+
 } // end namespace Gambit
@@ -38,6 +38,18 @@ GameOutcomeRep::GameOutcomeRep(GameRep *p_game, int p_number)
     m_payoffs(m_game->NumPlayers())
 { }
 
+void GameOutcomeRep::SetPayoff(int pl, const std::string &p_value)
+{
+  m_payoffs[pl] = p_value;
+  m_game->ClearComputedPayoffs();
+}
+
+void GameOutcomeRep::SetPayoff(int pl, const Number &p_value)
+{
+  m_payoffs[pl] = p_value;
+  m_game->ClearComputedPayoffs();
+}
+
 //========================================================================
 //                     class GameTreeActionRep
 //========================================================================
@@ -347,7 +359,7 @@ void GamePlayerRep::MakeReducedStrats(GameTreeNodeRep *n, GameTreeNodeRep *nn)
   }
   else if (nn)  {
     for (; ; nn = nn->m_parent->ptr->whichbranch)  {
-      m = dynamic_cast<GameTreeNodeRep *>(nn->GetNextSibling().operator->());
+      m = dynamic_cast<GameTreeNodeRep *>((GameNodeRep *) nn->GetNextSibling());
       if (m || nn->m_parent->ptr == NULL)   break;
     }
     if (m)  {
@@ -440,30 +452,8 @@ bool GameTreeNodeRep::IsSuccessorOf(GameNode p_node) const
 
 bool GameTreeNodeRep::IsSubgameRoot(void) const
 {
-  // First take care of a couple easy cases
-  if (children.Length() == 0 || infoset->NumMembers() > 1) return false;
-  if (!m_parent) return true;
-
-  // A node is a subgame root if and only if in every information set,
-  // either all members succeed the node in the tree,
-  // or all members do not succeed the node in the tree.
-  for (int pl = 1; pl <= m_efg->NumPlayers(); pl++) {
-    GamePlayerRep *player = m_efg->GetPlayer(pl);
-    
-    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-      GameTreeInfosetRep *infoset = dynamic_cast<GameTreeInfosetRep *>(player->GetInfoset(iset).operator->());
-
-      bool precedes = infoset->GetMember(1)->IsSuccessorOf(const_cast<GameTreeNodeRep *>(this));
-
-      for (int mem = 2; mem <= infoset->NumMembers(); mem++) {
-	if (infoset->GetMember(mem)->IsSuccessorOf(const_cast<GameTreeNodeRep *>(this)) != precedes) {
-	  return false;
-	}
-      }
-    }
-  }
-
-  return true;
+  const GameTreeIndex &index = m_efg->GetTreeIndex();
+  return index.IsSubgameRoot(number);
 }
 
 void GameTreeNodeRep::DeleteParent(void)
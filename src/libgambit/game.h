@@ -49,6 +49,9 @@ public:
   //@{
   /// Constructor; initializes reference count
   GameObject(void) : m_refCount(0), m_valid(true) { }
+  /// Destructor; virtual, since objects delete themselves through
+  /// Invalidate() and DecRef()
+  virtual ~GameObject() { }
   //@}
 
   /// @name Validation
@@ -212,9 +215,18 @@ public:
 
 /// Exception thrown on a parse error when reading a game savefile
 class InvalidFileException : public Exception {
+private:
+  std::string m_description;
+
 public:
+  InvalidFileException(void)
+    : m_description("File not in a recognized format") { }
+  /// Constructs the exception with a description of the error,
+  /// usually including where in the file it was found
+  InvalidFileException(const std::string &p_description)
+    : m_description(p_description) { }
   virtual ~InvalidFileException() throw() { }
-  const char *what(void) const throw()  { return "File not in a recognized format"; }
+  const char *what(void) const throw()  { return m_description.c_str(); }
 };
 
 //=======================================================================
@@ -262,11 +274,9 @@ public:
   template <class T> const T &GetPayoff(int pl) const 
     { return (const T &) m_payoffs[pl]; }
   /// Sets the payoff to player 'pl'
-  void SetPayoff(int pl, const std::string &p_value)
-  {
-    m_payoffs[pl] = p_value;
-    //m_game->ClearComputedValues();
-  }
+  void SetPayoff(int pl, const std::string &p_value);
+  /// Sets the payoff to player 'pl' from an already-parsed value
+  void SetPayoff(int pl, const Number &p_value);
   //@}
 };
 
@@ -347,7 +357,9 @@ class GameStrategyRep : public GameObject  {
   friend class GamePlayerRep;
   friend class PureStrategyProfileRep;
   friend class TreePureStrategyProfileRep;
+  friend class GameTreePayoffs;
   friend class TablePureStrategyProfileRep;
+  friend class ContingencyIterator;
   template <class T> friend class MixedStrategyProfile;
   template <class T> friend class TableMixedStrategyProfileRep;
   template <class T> friend class MixedBehavProfile;
@@ -395,6 +407,8 @@ class GamePlayerRep : public GameObject {
   friend class GameTreeInfosetRep;
   friend class GameStrategyRep;
   friend class GameTreeNodeRep;
+  friend class GameTreeIndex;
+  friend class GameTreePayoffs;
   template <class T> friend class MixedBehavProfile;
   template <class T> friend class MixedStrategyProfile;
 
@@ -597,6 +611,9 @@ public:
   virtual ~GameRep() { }
   /// Create a copy of the game, as a new game
   virtual Game Copy(void) const = 0;
+  /// Create a copy of the subtree starting at node, as a new game
+  virtual Game Copy(const GameNode &p_node) const
+  { throw UndefinedException(); }
   //@}
 
   /// @name General data access
@@ -635,6 +652,8 @@ public:
   virtual void Canonicalize(void) { }  
   /// Clear out any computed values
   virtual void ClearComputedValues(void) const { }
+  /// Clear out any values computed from the payoffs of outcomes
+  virtual void ClearComputedPayoffs(void) const { }
   /// Build any computed values anew
   virtual void BuildComputedValues(void) { }
   /// Have computed values been built?
@@ -652,6 +671,9 @@ public:
   /// Write the game in .nfg format to the specified stream
   virtual void WriteNfgFile(std::ostream &) const
   { throw UndefinedException(); }
+  /// Write the game as a binary snapshot to the specified stream
+  virtual void WriteSnapshotFile(std::ostream &) const
+  { throw UndefinedException(); }
   //@}
 
   /// @name Dimensions of the game
@@ -751,8 +773,12 @@ template<> inline std::string PureBehavProfile::GetPayoff(int pl) const
 //=======================================================================
 
 
-/// Reads a game in .efg or .nfg format from the input stream
+/// Reads a game in .efg or .nfg format, or a game snapshot, from the
+/// input stream
 Game ReadGame(std::istream &) throw (InvalidFileException);
+/// Reads a game in .efg or .nfg format, or a game snapshot, from the
+/// data in [begin, end), such as a memory-mapped file, without copying it
+Game ReadGame(const char *, const char *) throw (InvalidFileException);
 
 } // end namespace gambit
 
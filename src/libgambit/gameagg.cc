@@ -25,6 +25,7 @@
 
 #include "libgambit.h"
 #include "gameagg.h"
+#include "snapshot.h"
 
 namespace Gambit {
 
@@ -188,6 +189,67 @@ void GameAggRep::WriteAggFile(std::ostream &s) const{
 	  }
 }
 
+//
+// The AGG payoff structures are internal to libagg, so the body of an
+// AGG snapshot holds the game in .agg format, preceded by the title,
+// comment, and player and strategy labels, which that format omits.
+//
+void GameAggRep::WriteSnapshotFile(std::ostream &p_file) const
+{
+  SnapshotWriter writer(p_file, SNAPSHOT_AGG);
+  writer.WriteString(m_title);
+  writer.WriteString(m_comment);
+  writer.WriteInt(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = m_players[pl];
+    writer.WriteString(player->m_label);
+    writer.WriteInt(player->m_strategies.Length());
+    for (int st = 1; st <= player->m_strategies.Length(); st++) {
+      writer.WriteString(player->m_strategies[st]->m_label);
+    }
+  }
+
+  std::ostringstream agg;
+  WriteAggFile(agg);
+  writer.WriteString(agg.str());
+  writer.Flush();
+}
+
+Game GameAggRep::ReadSnapshot(SnapshotReader &p_reader)
+{
+  std::string title = p_reader.ReadString();
+  std::string comment = p_reader.ReadString();
+  Array<std::string> playerLabels(p_reader.ReadCount(8));
+  Array<Array<std::string> > strategyLabels(playerLabels.Length());
+  for (int pl = 1; pl <= playerLabels.Length(); pl++) {
+    playerLabels[pl] = p_reader.ReadString();
+    strategyLabels[pl] = Array<std::string>(p_reader.ReadCount(4));
+    for (int st = 1; st <= strategyLabels[pl].Length(); st++) {
+      strategyLabels[pl][st] = p_reader.ReadString();
+    }
+  }
+
+  std::istringstream is(p_reader.ReadString());
+  GameAggRep *agg = ReadAggFile(is);
+  Game game = agg;
+  if (agg->m_players.Length() != playerLabels.Length()) {
+    throw p_reader.Error();
+  }
+  agg->m_title = title;
+  agg->m_comment = comment;
+  for (int pl = 1; pl <= playerLabels.Length(); pl++) {
+    GamePlayerRep *player = agg->m_players[pl];
+    if (player->m_strategies.Length() != strategyLabels[pl].Length()) {
+      throw p_reader.Error();
+    }
+    player->m_label = playerLabels[pl];
+    for (int st = 1; st <= strategyLabels[pl].Length(); st++) {
+      player->m_strategies[st]->m_label = strategyLabels[pl][st];
+    }
+  }
+  return game;
+}
+
 GameAggRep* GameAggRep::ReadAggFile(istream& in){
 	agg* aggPtr=agg::makeAGG(in);
 	if(!aggPtr){
@@ -27,6 +27,8 @@
 
 namespace Gambit {
 
+class SnapshotReader;
+
 class GameAggRep : public GameRep {
   template <class T> friend class MixedStrategyProfile;
   template <class T> friend class AggMixedStrategyProfileRep;
@@ -186,6 +188,9 @@ public:
   //@{
   virtual void WriteNfgFile(std::ostream &) const;
   virtual void WriteAggFile(std::ostream &) const;
+  virtual void WriteSnapshotFile(std::ostream &) const;
+  /// Build an action-graph game from the body of a snapshot
+  static Game ReadSnapshot(SnapshotReader &);
   //@}
 };
 
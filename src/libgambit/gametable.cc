@@ -20,11 +20,13 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <climits>
 #include <iostream>
 #include <sstream>
 
 #include "libgambit.h"
 #include "gametable.h"
+#include "snapshot.h"
 
 namespace Gambit {
 
@@ -180,18 +182,17 @@ Game GameTableRep::Copy(void) const
 
 bool GameTableRep::IsConstSum(void) const
 {
-  TablePureStrategyProfileRep profile(const_cast<GameTableRep *>(this));
+  ContingencyIterator iter(StrategySupport(const_cast<GameTableRep *>(this)));
 
   Rational sum(0);
   for (int pl = 1; pl <= m_players.Length(); pl++) {
-    sum += profile.GetPayoff(pl);
+    sum += iter.GetPayoff<Rational>(pl);
   }
 
-  for (StrategyIterator iter(StrategySupport(const_cast<GameTableRep *>(this)));
-       !iter.AtEnd(); iter++) {
+  for (; !iter.AtEnd(); iter++) {
     Rational newsum(0);
     for (int pl = 1; pl <= m_players.Length(); pl++) {
-      newsum += (*iter)->GetPayoff(pl);
+      newsum += iter.GetPayoff<Rational>(pl);
     }
     
     if (newsum != sum) {
@@ -277,6 +278,97 @@ void GameTableRep::WriteNfgFile(std::ostream &p_file) const
   p_file << '\n';
 }
 
+//
+// The body of a table snapshot is:
+//   the title and comment;
+//   the number of players, and the number of strategies of each;
+//   for each player, its label and the labels of its strategies;
+//   the number of outcomes, and for each its label and payoffs;
+//   for each contingency, in table order, its outcome (0 for none).
+//
+void GameTableRep::WriteSnapshotFile(std::ostream &p_file) const
+{
+  SnapshotWriter writer(p_file, SNAPSHOT_TABLE);
+  writer.WriteString(m_title);
+  writer.WriteString(m_comment);
+
+  writer.WriteInt(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    writer.WriteInt(m_players[pl]->m_strategies.Length());
+  }
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = m_players[pl];
+    writer.WriteString(player->m_label);
+    for (int st = 1; st <= player->m_strategies.Length(); st++) {
+      writer.WriteString(player->m_strategies[st]->m_label);
+    }
+  }
+
+  writer.WriteInt(m_outcomes.Length());
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    writer.WriteString(m_outcomes[outc]->m_label);
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      writer.WriteNumber(m_outcomes[outc]->m_payoffs[pl]);
+    }
+  }
+
+  for (int cont = 1; cont <= m_results.Length(); cont++) {
+    writer.WriteInt((m_results[cont]) ? m_results[cont]->m_number : 0);
+  }
+  writer.Flush();
+}
+
+Game GameTableRep::ReadSnapshot(SnapshotReader &p_reader)
+{
+  std::string title = p_reader.ReadString();
+  std::string comment = p_reader.ReadString();
+
+  Array<int> dim(p_reader.ReadCount(4));
+  long ncont = 1;
+  for (int pl = 1; pl <= dim.Length(); pl++) {
+    dim[pl] = p_reader.ReadCount(4);
+    ncont *= dim[pl];
+    if (ncont > INT_MAX / 4)  throw p_reader.Error();
+  }
+  // Each contingency occupies four bytes at the end of the snapshot;
+  // checking this first avoids allocating a table for a corrupt file
+  p_reader.Require(4 * ncont);
+
+  GameTableRep *table = new GameTableRep(dim, true);
+  // Assigning this to the container assures that, if something goes
+  // wrong, the class will automatically be cleaned up
+  Game game = table;
+  table->m_title = title;
+  table->m_comment = comment;
+
+  for (int pl = 1; pl <= dim.Length(); pl++) {
+    GamePlayerRep *player = table->m_players[pl];
+    player->m_label = p_reader.ReadString();
+    for (int st = 1; st <= dim[pl]; st++) {
+      player->m_strategies[st]->m_label = p_reader.ReadString();
+    }
+  }
+
+  int numOutcomes = p_reader.ReadCount(4);
+  table->m_outcomes = Array<GameOutcomeRep *>(numOutcomes);
+  for (int outc = 1; outc <= numOutcomes; outc++) {
+    table->m_outcomes[outc] = new GameOutcomeRep(table, outc);
+  }
+  for (int outc = 1; outc <= numOutcomes; outc++) {
+    GameOutcomeRep *outcome = table->m_outcomes[outc];
+    outcome->m_label = p_reader.ReadString();
+    for (int pl = 1; pl <= dim.Length(); pl++) {
+      outcome->m_payoffs[pl] = p_reader.ReadNumber();
+    }
+  }
+
+  for (int cont = 1; cont <= table->m_results.Length(); cont++) {
+    int outc = p_reader.ReadIndex(0, numOutcomes);
+    table->m_results[cont] = (outc) ? table->m_outcomes[outc] : 0;
+  }
+  return game;
+}
+
 //------------------------------------------------------------------------
 //                       GameTableRep: Players
 //------------------------------------------------------------------------
@@ -27,9 +27,12 @@
 
 namespace Gambit {
 
+class SnapshotReader;
+
 class GameTableRep : public GameExplicitRep {
   friend class GamePlayerRep;
   friend class TablePureStrategyProfileRep;
+  friend class ContingencyIterator;
   template <class T> friend class TableMixedStrategyProfileRep;
 private:
   Array<GameOutcomeRep *> m_results;
@@ -108,6 +111,9 @@ public:
   /// @name Writing data files
   //@{
   virtual void WriteNfgFile(std::ostream &) const;
+  virtual void WriteSnapshotFile(std::ostream &) const;
+  /// Build a table game from the body of a snapshot
+  static Game ReadSnapshot(SnapshotReader &);
   //@}
 
   virtual PureStrategyProfile NewPureStrategyProfile(void) const;
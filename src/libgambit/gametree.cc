@@ -22,35 +22,594 @@
 
 #include <iostream>
 #include <sstream>
+#include <map>
+#include <vector>
+#include <algorithm>
 
 #include "libgambit.h"
 #include "gametree.h"
+#include "snapshot.h"
+#include "workpool.h"
 
 namespace Gambit {
 
+//========================================================================
+//                          class GameTreeIndex
+//========================================================================
+
+GameTreeIndex::GameTreeIndex(GameTreeNodeRep *p_root, 
+			     GamePlayerRep *p_chance,
+			     const Array<GamePlayerRep *> &p_players)
+{
+  // Number the information sets and actions; the first action at
+  // each information set is recorded to look up prior actions below
+  int numInfosets = 0, numActions = 0;
+  for (int pl = 0; pl <= p_players.Length(); pl++) {
+    GamePlayerRep *player = (pl) ? p_players[pl] : p_chance;
+    numInfosets += player->m_infosets.Length();
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      numActions += player->m_infosets[iset]->m_actions.Length();
+    }
+  }
+
+  m_infosets = Array<GameTreeInfosetRep *>(numInfosets);
+  m_actions = Array<GameTreeActionRep *>(numActions);
+  Array<int> playerOffsets(0, p_players.Length());
+  Array<int> actionOffsets(numInfosets);
+  for (int pl = 0, iset = 0, act = 0; pl <= p_players.Length(); pl++) {
+    GamePlayerRep *player = (pl) ? p_players[pl] : p_chance;
+    playerOffsets[pl] = iset;
+    for (int i = 1; i <= player->m_infosets.Length(); i++) {
+      GameTreeInfosetRep *infoset = player->m_infosets[i];
+      m_infosets[++iset] = infoset;
+      actionOffsets[iset] = act;
+      for (int j = 1; j <= infoset->m_actions.Length(); j++) {
+	m_actions[++act] = infoset->m_actions[j];
+      }
+    }
+  }
+
+  // List the nodes in preorder, using an explicit stack since very
+  // deep trees could otherwise exhaust the call stack
+  std::vector<GameTreeNodeRep *> nodes, stack(1, p_root);
+  while (!stack.empty()) {
+    GameTreeNodeRep *node = stack.back();
+    stack.pop_back();
+    node->number = nodes.size() + 1;
+    nodes.push_back(node);
+    for (int i = node->children.Length(); i >= 1; i--) {
+      stack.push_back(node->children[i]);
+    }
+  }
+
+  int numNodes = nodes.size();
+  m_nodes = Array<GameTreeNodeRep *>(numNodes);
+  m_parents = Array<int>(numNodes);
+  m_subtreeEnds = Array<int>(numNodes);
+  m_priorActions = Array<int>(numNodes);
+  m_nodeInfosets = Array<int>(numNodes);
+  m_outcomes = Array<GameOutcomeRep *>(numNodes);
+  m_depths = Array<int>(numNodes);
+
+  for (int i = 1; i <= numNodes; i++) {
+    GameTreeNodeRep *node = nodes[i-1];
+    m_nodes[i] = node;
+    m_outcomes[i] = node->outcome;
+    m_subtreeEnds[i] = i + 1;
+    m_nodeInfosets[i] = ((node->infoset) ? 
+			 playerOffsets[node->infoset->m_player->m_number] +
+			 node->infoset->m_number : 0);
+    m_parents[i] = m_priorActions[i] = m_depths[i] = 0;
+  }
+
+  for (int i = 1; i <= numNodes; i++) {
+    GameTreeNodeRep *node = m_nodes[i];
+    for (int j = 1; j <= node->children.Length(); j++) {
+      int child = node->children[j]->number;
+      m_parents[child] = i;
+      m_priorActions[child] = actionOffsets[m_nodeInfosets[i]] + j;
+      m_depths[child] = m_depths[i] + 1;
+    }
+  }
+
+  m_memberStarts = Array<int>(numInfosets + 1);
+  for (int iset = 1, k = 1; iset <= numInfosets + 1; iset++) {
+    m_memberStarts[iset] = k;
+    if (iset <= numInfosets)  k += m_infosets[iset]->m_members.Length();
+  }
+  m_members = Array<int>(m_memberStarts[numInfosets + 1] - 1);
+  for (int iset = 1, k = 1; iset <= numInfosets; iset++) {
+    GameTreeInfosetRep *infoset = m_infosets[iset];
+    for (int j = 1; j <= infoset->m_members.Length(); j++) {
+      m_members[k++] = infoset->m_members[j]->number;
+    }
+  }
+
+  // A node's subtree ends where that of its last child ends; children
+  // come after their parents, so a backward sweep sees them first
+  for (int i = numNodes; i >= 2; i--) {
+    if (m_subtreeEnds[i] > m_subtreeEnds[m_parents[i]]) {
+      m_subtreeEnds[m_parents[i]] = m_subtreeEnds[i];
+    }
+  }
+
+  // A node is the root of a subgame if every personal information set
+  // with a member in its subtree lies wholly within it.  Taking the
+  // first and last members of the information set at each node, and
+  // then the least and greatest of these over each subtree, this is
+  // checked in one more backward sweep.
+  Array<int> first(numNodes), last(numNodes);
+  for (int i = 1; i <= numNodes; i++) {
+    first[i] = last[i] = i;
+    GameTreeInfosetRep *infoset = m_nodes[i]->infoset;
+    if (infoset && infoset->m_player != p_chance) {
+      int iset = m_nodeInfosets[i];
+      for (int k = 1; k <= NumMembers(iset); k++) {
+	int member = GetMember(iset, k);
+	if (member < first[i])  first[i] = member;
+	if (member > last[i])  last[i] = member;
+      }
+    }
+  }
+  for (int i = numNodes; i >= 2; i--) {
+    int parent = m_parents[i];
+    if (first[i] < first[parent])  first[parent] = first[i];
+    if (last[i] > last[parent])  last[parent] = last[i];
+  }
+
+  m_subgameRoots = Array<bool>(numNodes);
+  for (int i = 1; i <= numNodes; i++) {
+    GameTreeNodeRep *node = m_nodes[i];
+    m_subgameRoots[i] = (node->children.Length() > 0 &&
+			 node->infoset->m_members.Length() <= 1 &&
+			 (i == 1 || (first[i] >= i && 
+				     last[i] < m_subtreeEnds[i])));
+  }
+
+  m_perfectRecall = m_recallInfoset1 = m_recallInfoset2 = 0;
+}
+
+int GameTreeIndex::GetActionTowards(int p_node, int p_successor) const
+{
+  int child = p_node + 1;
+  for (int act = 1; child < m_subtreeEnds[p_node]; act++) {
+    if (p_successor < m_subtreeEnds[child])  return act;
+    child = m_subtreeEnds[child];
+  }
+  return 0;
+}
+
+bool GameTreeIndex::IsPerfectRecall(int &p_infoset1, int &p_infoset2) const
+{
+  if (m_perfectRecall == 0)  ComputePerfectRecall();
+  if (m_perfectRecall < 0) {
+    p_infoset1 = m_recallInfoset1;
+    p_infoset2 = m_recallInfoset2;
+  }
+  return (m_perfectRecall > 0);
+}
+
+//
+// This makes the same checks, in the same order, as the search over
+// all pairs of a player's information sets that it replaces, so the
+// same pair is reported.  Only pairs in which a member of the first
+// information set precedes a member of the second can fail; these are
+// found by walking up from each member of each information set.
+//
+void GameTreeIndex::ComputePerfectRecall(void) const
+{
+  m_perfectRecall = 1;
+
+  int numInfosets = m_infosets.Length(), firstPersonal = 1;
+  while (firstPersonal <= numInfosets &&
+	 m_infosets[firstPersonal]->m_player->IsChance()) {
+    firstPersonal++;
+  }
+
+  std::vector<std::pair<int, int> > pairs;
+  for (int j = firstPersonal; j <= numInfosets; j++) {
+    GamePlayerRep *player = m_infosets[j]->m_player;
+    for (int m = 1; m <= NumMembers(j); m++) {
+      for (int n = m_parents[GetMember(j, m)]; n > 0; n = m_parents[n]) {
+	int i = m_nodeInfosets[n];
+	if (m_infosets[i]->m_player == player) {
+	  pairs.push_back(std::pair<int, int>(i, j));
+	}
+      }
+    }
+  }
+  std::sort(pairs.begin(), pairs.end());
+  pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+  for (size_t p = 0; p < pairs.size(); p++) {
+    int i = pairs[p].first, j = pairs[p].second;
+    bool precedes = false, failed = false;
+    int action = 0;
+
+    for (int m = 1; !failed && m <= NumMembers(j); m++) {
+      int member2 = GetMember(j, m);
+      bool found = false;
+      for (int n = 1; !found && n <= NumMembers(i); n++) {
+	int member1 = GetMember(i, n);
+	if (member1 != member2 && IsSuccessor(member2, member1)) {
+	  precedes = found = true;
+	  int act = GetActionTowards(member1, member2);
+	  if (action != 0 && action != act) {
+	    failed = true;
+	  }
+	  action = act;
+	}
+      }
+
+      if (precedes && (i == j || !found)) {
+	failed = true;
+      }
+    }
+
+    if (failed) {
+      m_perfectRecall = -1;
+      m_recallInfoset1 = i;
+      m_recallInfoset2 = j;
+      return;
+    }
+  }
+}
+
+//========================================================================
+//                         class GameTreePayoffs
+//========================================================================
+
+namespace {
+
+//
+// The tree and strategies, copied into plain arrays so that tasks need
+// not touch the game objects
+//
+class PayoffTree {
+public:
+  int m_numPlayers;
+  // For each node, its player (zero for chance, -1 if terminal), the
+  // number of its information set for that player, and its children
+  std::vector<int> m_nodePlayers, m_nodeInfosets, m_firstChild;
+  std::vector<int> m_children;
+  // The probability of each child of a chance node, in m_children order
+  std::vector<Rational> m_probs;
+  // The payoffs from the outcome at each node, if any
+  std::vector<bool> m_hasOutcome;
+  std::vector<Rational> m_payoffs;
+  // The actions of each strategy, and the offset of each strategy
+  std::vector<std::vector<std::vector<int> > > m_behavs;
+  std::vector<std::vector<long> > m_offsets;
+};
+
+//
+// Each level of the walk belongs to a player.  The nodes at which the
+// walk stops for later players are passed on to the next level, with
+// the probability of reaching them.
+//
+class PayoffLevel {
+public:
+  std::vector<std::pair<int, Rational> > m_frontier;
+  Array<Rational> m_value;
+};
+
+class PayoffTask : public WorkTask {
+private:
+  const PayoffTree &m_tree;
+  const PayoffLevel &m_start;
+  int m_strategy;
+  Array<Rational> &m_table;
+  Array<PayoffLevel> m_levels;
+  Array<int> m_choices;
+  std::vector<std::pair<int, Rational> > m_stack;
+
+  void Walk(int p_level, const PayoffLevel &p_from, long p_index);
+
+public:
+  PayoffTask(const PayoffTree &p_tree, const PayoffLevel &p_start,
+	     int p_strategy, Array<Rational> &p_table)
+    : m_tree(p_tree), m_start(p_start), m_strategy(p_strategy),
+      m_table(p_table), m_levels(p_tree.m_numPlayers),
+      m_choices(p_tree.m_numPlayers)
+  { }
+  void Run(void) { Walk(1, m_start, 1L); }
+};
+
+//
+// Walks from the frontier of the previous level, for each strategy of
+// the player at this level (only m_strategy at the first level).
+// Outcomes are credited as their nodes are entered, so nodes on the
+// frontier have already been credited.
+//
+void PayoffTask::Walk(int p_level, const PayoffLevel &p_from, long p_index)
+{
+  const PayoffTree &tree = m_tree;
+  int numPlayers = tree.m_numPlayers;
+  PayoffLevel &level = m_levels[p_level];
+  int first = 1, last = tree.m_behavs[p_level].size() - 1;
+  if (p_level == 1)  first = last = m_strategy;
+
+  for (int st = first; st <= last; st++) {
+    m_choices[p_level] = st;
+    level.m_frontier.clear();
+    level.m_value = p_from.m_value;
+
+    for (size_t k = 0; k < p_from.m_frontier.size(); k++) {
+      m_stack.push_back(p_from.m_frontier[k]);
+      bool entered = false;
+      while (!m_stack.empty()) {
+	int node = m_stack.back().first;
+	Rational prob = m_stack.back().second;
+	m_stack.pop_back();
+
+	if (entered && tree.m_hasOutcome[node]) {
+	  for (int pl = 1; pl <= numPlayers; pl++) {
+	    level.m_value[pl] += prob * tree.m_payoffs[(node - 1) * numPlayers + pl - 1];
+	  }
+	}
+	entered = true;
+
+	int player = tree.m_nodePlayers[node];
+	if (player < 0) {
+	  continue;
+	}
+	else if (player == 0) {
+	  for (int i = tree.m_firstChild[node]; i < tree.m_firstChild[node + 1]; i++) {
+	    m_stack.push_back(std::make_pair(tree.m_children[i],
+					     prob * tree.m_probs[i]));
+	  }
+	}
+	else if (player <= p_level) {
+	  int act = tree.m_behavs[player][m_choices[player]][tree.m_nodeInfosets[node]];
+	  if (act > 0) {
+	    int child = tree.m_children[tree.m_firstChild[node] + act - 1];
+	    m_stack.push_back(std::make_pair(child, prob));
+	  }
+	}
+	else {
+	  level.m_frontier.push_back(std::make_pair(node, prob));
+	}
+      }
+    }
+
+    long index = p_index + tree.m_offsets[p_level][st];
+    if (p_level < numPlayers) {
+      Walk(p_level + 1, level, index);
+    }
+    else {
+      for (int pl = 1; pl <= numPlayers; pl++) {
+	m_table[(index - 1) * numPlayers + pl] = level.m_value[pl];
+      }
+    }
+  }
+}
+
+}  // end anonymous namespace
+
+GameTreePayoffs::GameTreePayoffs(const GameTreeRep &p_tree)
+  : m_numPlayers(p_tree.NumPlayers())
+{
+  const GameTreeIndex &index = p_tree.GetTreeIndex();
+  int numNodes = index.NumNodes();
+
+  PayoffTree tree;
+  tree.m_numPlayers = m_numPlayers;
+  tree.m_nodePlayers.resize(numNodes + 1);
+  tree.m_nodeInfosets.resize(numNodes + 1);
+  tree.m_firstChild.resize(numNodes + 2);
+  tree.m_hasOutcome.resize(numNodes + 1);
+  tree.m_payoffs.resize(numNodes * m_numPlayers);
+  for (int i = 1; i <= numNodes; i++) {
+    GameTreeNodeRep *node = index.GetNode(i);
+    tree.m_firstChild[i] = tree.m_children.size();
+    if (node->infoset) {
+      tree.m_nodePlayers[i] = node->infoset->m_player->m_number;
+      tree.m_nodeInfosets[i] = node->infoset->m_number;
+      for (int j = 1; j <= node->children.Length(); j++) {
+	tree.m_children.push_back(node->children[j]->number);
+	tree.m_probs.push_back((node->infoset->m_player->IsChance()) ?
+			       node->infoset->GetActionProb(j, Rational(0)) :
+			       Rational(0));
+      }
+    }
+    else {
+      tree.m_nodePlayers[i] = -1;
+      tree.m_nodeInfosets[i] = 0;
+    }
+    tree.m_hasOutcome[i] = (node->outcome != 0);
+    if (node->outcome) {
+      for (int pl = 1; pl <= m_numPlayers; pl++) {
+	tree.m_payoffs[(i - 1) * m_numPlayers + pl - 1] = 
+	  node->outcome->GetPayoff<Rational>(pl);
+      }
+    }
+  }
+  tree.m_firstChild[numNodes + 1] = tree.m_children.size();
+
+  long numContingencies = 1L;
+  tree.m_behavs.resize(m_numPlayers + 1);
+  tree.m_offsets.resize(m_numPlayers + 1);
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    GamePlayerRep *player = p_tree.m_players[pl];
+    tree.m_behavs[pl].resize(player->m_strategies.Length() + 1);
+    tree.m_offsets[pl].resize(player->m_strategies.Length() + 1);
+    for (int st = 1; st <= player->m_strategies.Length(); st++) {
+      GameStrategyRep *strategy = player->m_strategies[st];
+      std::vector<int> &behav = tree.m_behavs[pl][st];
+      behav.resize(strategy->m_behav.Length() + 1);
+      for (int iset = 1; iset <= strategy->m_behav.Length(); iset++) {
+	behav[iset] = strategy->m_behav[iset];
+      }
+      tree.m_offsets[pl][st] = strategy->m_offset;
+    }
+    numContingencies *= player->m_strategies.Length();
+  }
+  m_payoffs = Array<Rational>(numContingencies * m_numPlayers);
+
+  if (m_numPlayers == 0)  return;
+
+  // The walk up to the moves of the first player is shared by all
+  PayoffLevel start;
+  start.m_frontier.push_back(std::make_pair(1, Rational(1)));
+  start.m_value = Array<Rational>(m_numPlayers);
+  if (tree.m_hasOutcome[1]) {
+    for (int pl = 1; pl <= m_numPlayers; pl++) {
+      start.m_value[pl] = tree.m_payoffs[pl - 1];
+    }
+  }
+
+  // The contingencies are divided by the strategy of the first player
+  int numTasks = p_tree.m_players[1]->m_strategies.Length();
+  Array<PayoffTask *> tasks(numTasks);
+  for (int st = 1; st <= numTasks; st++) {
+    tasks[st] = new PayoffTask(tree, start, st, m_payoffs);
+  }
+  try {
+    WorkPool pool((numTasks > 1) ? 0 : 1);
+    WorkGroup group(pool);
+    for (int st = 1; st <= numTasks; st++) {
+      group.Submit(tasks[st]);
+    }
+    group.Wait();
+  }
+  catch (...) {
+    for (int st = 1; st <= numTasks; st++)  delete tasks[st];
+    throw;
+  }
+  for (int st = 1; st <= numTasks; st++)  delete tasks[st];
+}
+
 //------------------------------------------------------------------------
 //                     GameTreeRep: Lifecycle
 //------------------------------------------------------------------------
 
 GameTreeRep::GameTreeRep(void)
+  : m_index(0), m_payoffTable(0)
 {
-  m_computedValues = false;
+  m_computedValues = m_canonical = false;
   m_chance = new GamePlayerRep(this, 0);
   m_root = new GameTreeNodeRep(this, 0);
 }
 
 GameTreeRep::~GameTreeRep()
 {
+  delete m_index;
+  delete m_payoffTable;
   m_root->Invalidate();
   m_chance->Invalidate();
 }
 
 Game GameTreeRep::Copy(void) const
 {
-  std::ostringstream os;
-  WriteEfgFile(os);
-  std::istringstream is(os.str());
-  return ReadGame(is);
+  return Copy(m_root);
+}
+
+//
+// The copy is built directly, rather than by writing the subtree in
+// .efg format and reading it back, but the result is the same: nodes
+// are numbered in preorder, and information sets and outcomes are
+// numbered in the order in which they are first reached.  Outcomes not
+// attached to any node of the subtree are not copied.
+//
+Game GameTreeRep::Copy(const GameNode &p_node) const
+{
+  GameTreeRep *tree = new GameTreeRep;
+  Game game = tree;
+  tree->m_title = m_title;
+  tree->m_comment = m_comment;
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    tree->m_players.Append(new GamePlayerRep(tree, pl));
+    tree->m_players[pl]->m_label = m_players[pl]->m_label;
+  }
+
+  // Information sets, their members, and outcomes are collected as they
+  // are reached, and stored in the game at the end, so that building the
+  // copy takes time linear in the size of the subtree
+  std::map<GameTreeInfosetRep *, int> infosetIndex;
+  std::vector<GameTreeInfosetRep *> infosets;
+  std::vector<std::vector<GameTreeNodeRep *> > members;
+  std::vector<int> numInfosets(m_players.Length() + 1, 0);
+  std::map<GameOutcomeRep *, GameOutcomeRep *> outcomeCopies;
+  std::vector<GameOutcomeRep *> outcomes;
+
+  // Pairs of an original node and its copy, still to be visited
+  std::vector<std::pair<GameTreeNodeRep *, GameTreeNodeRep *> > stack;
+  stack.push_back(std::make_pair(dynamic_cast<GameTreeNodeRep *>(p_node.operator->()),
+				 tree->m_root));
+  int number = 1;
+  while (!stack.empty()) {
+    GameTreeNodeRep *node = stack.back().first;
+    GameTreeNodeRep *copy = stack.back().second;
+    stack.pop_back();
+    copy->number = number++;
+    copy->m_label = node->m_label;
+
+    if (node->infoset) {
+      GameTreeInfosetRep *original = node->infoset;
+      if (!infosetIndex.count(original)) {
+	int pl = original->m_player->m_number;
+	GamePlayerRep *player = (pl) ? tree->m_players[pl] : tree->m_chance;
+	// The constructor appends the information set to the player's
+	// list; the lists are assigned in full at the end
+	GameTreeInfosetRep *infoset = 
+	  new GameTreeInfosetRep(tree, ++numInfosets[pl], player,
+				 original->m_actions.Length());
+	player->m_infosets = Array<GameTreeInfosetRep *>();
+	infoset->m_label = original->m_label;
+	for (int act = 1; act <= original->m_actions.Length(); act++) {
+	  infoset->m_actions[act]->m_label = original->m_actions[act]->m_label;
+	}
+	if (pl == 0) {
+	  infoset->m_probs = original->m_probs;
+	}
+	infosetIndex[original] = infosets.size();
+	infosets.push_back(infoset);
+	members.push_back(std::vector<GameTreeNodeRep *>());
+      }
+      int index = infosetIndex[original];
+      copy->infoset = infosets[index];
+      members[index].push_back(copy);
+
+      copy->children = Array<GameTreeNodeRep *>(node->children.Length());
+      for (int i = 1; i <= node->children.Length(); i++) {
+	copy->children[i] = new GameTreeNodeRep(tree, copy);
+      }
+      for (int i = node->children.Length(); i >= 1; i--) {
+	stack.push_back(std::make_pair(node->children[i], copy->children[i]));
+      }
+    }
+
+    if (node->outcome) {
+      GameOutcomeRep *&outcome = outcomeCopies[node->outcome];
+      if (!outcome) {
+	outcome = new GameOutcomeRep(tree, outcomes.size() + 1);
+	outcome->m_label = node->outcome->m_label;
+	outcome->m_payoffs = node->outcome->m_payoffs;
+	outcomes.push_back(outcome);
+      }
+      copy->outcome = outcome;
+    }
+  }
+
+  for (int pl = 0; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = (pl) ? tree->m_players[pl] : tree->m_chance;
+    player->m_infosets = Array<GameTreeInfosetRep *>(numInfosets[pl]);
+  }
+  for (size_t i = 0; i < infosets.size(); i++) {
+    GameTreeInfosetRep *infoset = infosets[i];
+    infoset->m_player->m_infosets[infoset->m_number] = infoset;
+    infoset->m_members = Array<GameTreeNodeRep *>(members[i].size());
+    for (size_t j = 0; j < members[i].size(); j++) {
+      infoset->m_members[j + 1] = members[i][j];
+    }
+  }
+
+  tree->m_outcomes = Array<GameOutcomeRep *>(outcomes.size());
+  for (size_t i = 0; i < outcomes.size(); i++) {
+    tree->m_outcomes[i + 1] = outcomes[i];
+  }
+
+  return game;
 }
 
 Game NewTree(void)  { return new GameTreeRep(); }
@@ -104,54 +663,12 @@ bool GameTreeRep::IsConstSum(void) const
 
 bool GameTreeRep::IsPerfectRecall(GameInfoset &s1, GameInfoset &s2) const
 {
-  for (int pl = 1; pl <= m_players.Length(); pl++)   {
-    GamePlayerRep *player = m_players[pl];
-    
-    for (int i = 1; i <= player->NumInfosets(); i++)  {
-      GameTreeInfosetRep *iset1 = player->m_infosets[i];
-      for (int j = 1; j <= player->NumInfosets(); j++)   {
-	GameTreeInfosetRep *iset2 = player->m_infosets[j];
-
-	bool precedes = false;
-	int action = 0;
-	
-	for (int m = 1; m <= iset2->NumMembers(); m++)  {
-	  int n;
-	  for (n = 1; n <= iset1->NumMembers(); n++)  {
-	    if (iset2->GetMember(m)->IsSuccessorOf(iset1->GetMember(n)) &&
-	        iset1->GetMember(n) != iset2->GetMember(m))  {
-	      precedes = true;
-	      for (int act = 1; act <= iset1->NumActions(); act++)  {
-		if (iset2->GetMember(m)->IsSuccessorOf(iset1->GetMember(n)->GetChild(act))) {
-		  if (action != 0 && action != act)  {
-		    s1 = iset1;
-		    s2 = iset2;
-		    return false;
-		  }
-		  action = act;
-		}
-	      }
-	      break;
-	    }
-	  }
-	  
-	  if (i == j && precedes)  {
-	    s1 = iset1;
-	    s2 = iset2;
-	    return false;
-	  }
-
-	  if (n > iset1->NumMembers() && precedes)  {
-	    s1 = iset1;
-	    s2 = iset2;
-	    return false;
-	  }
-	}
-      }
-    }
-  }
-
-  return true;
+  const GameTreeIndex &index = GetTreeIndex();
+  int iset1, iset2;
+  if (index.IsPerfectRecall(iset1, iset2))  return true;
+  s1 = index.GetInfoset(iset1);
+  s2 = index.GetInfoset(iset2);
+  return false;
 }
 
 
@@ -168,6 +685,13 @@ void GameTreeRep::NumberNodes(GameTreeNodeRep *n, int &index)
 
 void GameTreeRep::Canonicalize(void)
 {
+  // Nothing changes unless the tree has been edited since last time
+  if (m_canonical)  return;
+
+  // Information sets may be renumbered
+  delete m_index;
+  m_index = 0;
+
   int nodeindex = 1;
   NumberNodes(m_root, nodeindex);
 
@@ -213,6 +737,8 @@ void GameTreeRep::Canonicalize(void)
       player->m_infosets[iset]->m_number = iset;
     }
   }
+
+  m_canonical = true;
 }
 
 void GameTreeRep::ClearComputedValues(void) const
@@ -223,7 +749,30 @@ void GameTreeRep::ClearComputedValues(void) const
     }
   }
 
-  m_computedValues = false;
+  delete m_index;
+  m_index = 0;
+  ClearComputedPayoffs();
+  m_computedValues = m_canonical = false;
+}
+
+void GameTreeRep::ClearComputedPayoffs(void) const
+{
+  delete m_payoffTable;
+  m_payoffTable = 0;
+}
+
+void GameTreeRep::IndexStrategies(void)
+{
+  long offset = 1L;
+
+  for (int pl = 1, id = 1; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = m_players[pl];
+    for (int st = 1; st <= player->m_strategies.Length(); st++) {
+      player->m_strategies[st]->m_id = id++;
+      player->m_strategies[st]->m_offset = (st - 1) * offset;
+    }
+    offset *= player->m_strategies.Length();
+  }
 }
 
 void GameTreeRep::BuildComputedValues(void)
@@ -236,12 +785,36 @@ void GameTreeRep::BuildComputedValues(void)
     m_players[pl]->MakeReducedStrats(m_root, 0);
   }
 
-  for (int pl = 1, id = 1; pl <= m_players.Length(); pl++) {
-    for (int st = 1; st <= m_players[pl]->m_strategies.Length(); 
-	 m_players[pl]->m_strategies[st++]->m_id = id++);
+  IndexStrategies();
+  GetTreeIndex();
+  m_computedValues = true;
+}
+
+const GameTreeIndex &GameTreeRep::GetTreeIndex(void) const
+{
+  if (!m_index) {
+    m_index = new GameTreeIndex(m_root, m_chance, m_players);
   }
+  return *m_index;
+}
 
-  m_computedValues = true;
+//
+// Storing the table takes memory in proportion to the number of
+// contingencies; beyond this many payoffs, each is computed on request
+//
+const long c_maxTablePayoffs = 1L << 22;
+
+const GameTreePayoffs *GameTreeRep::GetPayoffTable(void) const
+{
+  if (!m_payoffTable && m_computedValues) {
+    long size = NumPlayers();
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      size *= m_players[pl]->m_strategies.Length();
+      if (size > c_maxTablePayoffs)  return 0;
+    }
+    m_payoffTable = new GameTreePayoffs(*this);
+  }
+  return m_payoffTable;
 }
 
 //------------------------------------------------------------------------
@@ -401,6 +974,235 @@ void GameTreeRep::WriteNfgFile(std::ostream &p_file) const
   p_file << '\n';
 }
 
+//
+// The body of a tree snapshot is:
+//   the title and comment;
+//   the number of players, and their labels;
+//   for chance and then each player, the number of information sets,
+//   the number of actions at each, and then for each information set
+//   its label, action labels, action probabilities (for chance only),
+//   and number of member nodes;
+//   the number of outcomes, and for each its label and payoffs;
+//   the nodes, in preorder, each with its label, player (-1 for a
+//   terminal node) and information set, and outcome (0 for none);
+//   a flag indicating whether the reduced strategies follow, and if so,
+//   for each player the number of strategies, and for each strategy its
+//   label and the action it prescribes at each information set.
+// The game is canonicalized before it is written, so node numbers and
+// the order of members within information sets follow the preorder.
+//
+void GameTreeRep::WriteSnapshotFile(std::ostream &p_file) const
+{
+  const_cast<GameTreeRep *>(this)->Canonicalize();
+
+  SnapshotWriter writer(p_file, SNAPSHOT_TREE);
+  writer.WriteString(m_title);
+  writer.WriteString(m_comment);
+
+  writer.WriteInt(m_players.Length());
+  for (int pl = 1; pl <= m_players.Length(); pl++) {
+    writer.WriteString(m_players[pl]->m_label);
+  }
+
+  for (int pl = 0; pl <= m_players.Length(); pl++) {
+    GamePlayerRep *player = (pl) ? m_players[pl] : m_chance;
+    writer.WriteInt(player->m_infosets.Length());
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      writer.WriteInt(player->m_infosets[iset]->m_actions.Length());
+    }
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      GameTreeInfosetRep *infoset = player->m_infosets[iset];
+      writer.WriteString(infoset->m_label);
+      for (int act = 1; act <= infoset->m_actions.Length(); act++) {
+	writer.WriteString(infoset->m_actions[act]->m_label);
+      }
+      if (player == m_chance) {
+	for (int act = 1; act <= infoset->m_actions.Length(); act++) {
+	  writer.WriteNumber(infoset->m_probs[act]);
+	}
+      }
+      writer.WriteInt(infoset->m_members.Length());
+    }
+  }
+
+  writer.WriteInt(m_outcomes.Length());
+  for (int outc = 1; outc <= m_outcomes.Length(); outc++) {
+    writer.WriteString(m_outcomes[outc]->m_label);
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      writer.WriteNumber(m_outcomes[outc]->m_payoffs[pl]);
+    }
+  }
+
+  // The traversal uses an explicit stack, since very deep trees could
+  // otherwise exhaust the call stack
+  std::vector<GameTreeNodeRep *> stack(1, m_root);
+  while (!stack.empty()) {
+    GameTreeNodeRep *node = stack.back();
+    stack.pop_back();
+    writer.WriteString(node->m_label);
+    if (node->infoset) {
+      writer.WriteInt(node->infoset->m_player->m_number);
+      writer.WriteInt(node->infoset->m_number);
+    }
+    else {
+      writer.WriteInt(-1);
+    }
+    writer.WriteInt((node->outcome) ? node->outcome->m_number : 0);
+    for (int i = node->children.Length(); i >= 1; i--) {
+      stack.push_back(node->children[i]);
+    }
+  }
+
+  writer.WriteInt(m_computedValues);
+  if (m_computedValues) {
+    for (int pl = 1; pl <= m_players.Length(); pl++) {
+      GamePlayerRep *player = m_players[pl];
+      writer.WriteInt(player->m_strategies.Length());
+      for (int st = 1; st <= player->m_strategies.Length(); st++) {
+	GameStrategyRep *strategy = player->m_strategies[st];
+	writer.WriteString(strategy->m_label);
+	for (int iset = 1; iset <= strategy->m_behav.Length(); iset++) {
+	  writer.WriteInt(strategy->m_behav[iset]);
+	}
+      }
+    }
+  }
+  writer.Flush();
+}
+
+//
+// Objects are created before the data describing them is read, so that
+// if the snapshot turns out to be corrupt, everything read so far is
+// owned by the game and cleaned up with it.
+//
+Game GameTreeRep::ReadSnapshot(SnapshotReader &p_reader)
+{
+  GameTreeRep *tree = new GameTreeRep;
+  Game game = tree;
+  tree->m_title = p_reader.ReadString();
+  tree->m_comment = p_reader.ReadString();
+
+  int numPlayers = p_reader.ReadCount(4);
+  for (int pl = 1; pl <= numPlayers; pl++) {
+    tree->m_players.Append(new GamePlayerRep(tree, pl));
+    tree->m_players[pl]->m_label = p_reader.ReadString();
+  }
+
+  // Number of member nodes of each information set seen so far
+  std::vector<std::vector<int> > filled(numPlayers + 1);
+
+  for (int pl = 0; pl <= numPlayers; pl++) {
+    GamePlayerRep *player = (pl) ? tree->m_players[pl] : tree->m_chance;
+    int numInfosets = p_reader.ReadCount(4);
+    Array<GameTreeInfosetRep *> infosets(numInfosets);
+    for (int iset = 1; iset <= numInfosets; iset++) {
+      // The constructor appends the information set to the player's
+      // list; emptying that list each time, and assigning the whole
+      // list at the end, avoids copying it for every information set
+      infosets[iset] = new GameTreeInfosetRep(tree, iset, player,
+					      p_reader.ReadCount(4));
+      player->m_infosets = Array<GameTreeInfosetRep *>();
+    }
+    player->m_infosets = infosets;
+
+    for (int iset = 1; iset <= numInfosets; iset++) {
+      GameTreeInfosetRep *infoset = infosets[iset];
+      infoset->m_label = p_reader.ReadString();
+      for (int act = 1; act <= infoset->m_actions.Length(); act++) {
+	infoset->m_actions[act]->m_label = p_reader.ReadString();
+      }
+      if (pl == 0) {
+	for (int act = 1; act <= infoset->m_actions.Length(); act++) {
+	  infoset->m_probs[act] = p_reader.ReadNumber();
+	}
+      }
+      infoset->m_members = Array<GameTreeNodeRep *>(p_reader.ReadCount(12));
+    }
+    filled[pl] = std::vector<int>(numInfosets + 1, 0);
+  }
+
+  int numOutcomes = p_reader.ReadCount(4);
+  tree->m_outcomes = Array<GameOutcomeRep *>(numOutcomes);
+  for (int outc = 1; outc <= numOutcomes; outc++) {
+    tree->m_outcomes[outc] = new GameOutcomeRep(tree, outc);
+  }
+  for (int outc = 1; outc <= numOutcomes; outc++) {
+    GameOutcomeRep *outcome = tree->m_outcomes[outc];
+    outcome->m_label = p_reader.ReadString();
+    for (int pl = 1; pl <= numPlayers; pl++) {
+      outcome->m_payoffs[pl] = p_reader.ReadNumber();
+    }
+  }
+
+  std::vector<GameTreeNodeRep *> stack(1, tree->m_root);
+  int number = 1;
+  while (!stack.empty()) {
+    GameTreeNodeRep *node = stack.back();
+    stack.pop_back();
+    node->number = number++;
+    node->m_label = p_reader.ReadString();
+
+    int pl = p_reader.ReadIndex(-1, numPlayers);
+    if (pl >= 0) {
+      GamePlayerRep *player = (pl) ? tree->m_players[pl] : tree->m_chance;
+      int iset = p_reader.ReadIndex(1, player->m_infosets.Length());
+      GameTreeInfosetRep *infoset = player->m_infosets[iset];
+      if (filled[pl][iset] == infoset->m_members.Length()) {
+	throw p_reader.Error();
+      }
+      infoset->m_members[++filled[pl][iset]] = node;
+      node->infoset = infoset;
+
+      node->children = Array<GameTreeNodeRep *>(infoset->m_actions.Length());
+      for (int i = 1; i <= node->children.Length(); i++) {
+	node->children[i] = new GameTreeNodeRep(tree, node);
+      }
+      for (int i = node->children.Length(); i >= 1; i--) {
+	stack.push_back(node->children[i]);
+      }
+    }
+
+    int outc = p_reader.ReadIndex(0, numOutcomes);
+    node->outcome = (outc) ? tree->m_outcomes[outc] : 0;
+  }
+
+  for (int pl = 0; pl <= numPlayers; pl++) {
+    GamePlayerRep *player = (pl) ? tree->m_players[pl] : tree->m_chance;
+    for (int iset = 1; iset <= player->m_infosets.Length(); iset++) {
+      if (filled[pl][iset] != player->m_infosets[iset]->m_members.Length()) {
+	throw p_reader.Error();
+      }
+    }
+  }
+
+  if (p_reader.ReadIndex(0, 1)) {
+    for (int pl = 1, id = 1; pl <= numPlayers; pl++) {
+      GamePlayerRep *player = tree->m_players[pl];
+      int numStrats = p_reader.ReadCount(4 + 4 * player->m_infosets.Length());
+      player->m_strategies = Array<GameStrategyRep *>(numStrats);
+      for (int st = 1; st <= numStrats; st++) {
+	GameStrategyRep *strategy = new GameStrategyRep(player);
+	player->m_strategies[st] = strategy;
+	strategy->m_number = st;
+	strategy->m_id = id++;
+	strategy->m_behav = Array<int>(player->m_infosets.Length());
+      }
+      for (int st = 1; st <= numStrats; st++) {
+	GameStrategyRep *strategy = player->m_strategies[st];
+	strategy->m_label = p_reader.ReadString();
+	for (int iset = 1; iset <= strategy->m_behav.Length(); iset++) {
+	  strategy->m_behav[iset] = 
+	    p_reader.ReadIndex(0, player->m_infosets[iset]->m_actions.Length());
+	}
+      }
+    }
+    tree->IndexStrategies();
+    tree->m_computedValues = true;
+  }
+
+  return game;
+}
+
 //------------------------------------------------------------------------
 //                 GameTreeRep: Dimensions of the game
 //------------------------------------------------------------------------
@@ -564,9 +1366,13 @@ MixedStrategyProfile<Rational> GameTreeRep::NewMixedStrategyProfile(const Ration
 //========================================================================
 
 class TreePureStrategyProfileRep : public PureStrategyProfileRep {
+protected:
+  long m_index;
+
 public:
   TreePureStrategyProfileRep(const Game &p_game);
   virtual PureStrategyProfile Copy(void) const;
+  virtual long GetIndex(void) const { return m_index; }
   virtual void SetStrategy(const GameStrategy &);
   virtual GameOutcome GetOutcome(void) const
   { throw UndefinedException(); }
@@ -582,10 +1388,12 @@ public:
 
 TreePureStrategyProfileRep::TreePureStrategyProfileRep(const Game &p_nfg)
 {
+  m_index = 1L;
   m_nfg = p_nfg;
   m_profile = Array<GameStrategy>(m_nfg->NumPlayers());
   for (int pl = 1; pl <= m_nfg->NumPlayers(); pl++)   {
     m_profile[pl] = m_nfg->GetPlayer(pl)->GetStrategy(1);
+    m_index += m_profile[pl]->m_offset;
   }
 }
 
@@ -605,11 +1413,18 @@ PureStrategyProfile GameTreeRep::NewPureStrategyProfile(void) const
 
 void TreePureStrategyProfileRep::SetStrategy(const GameStrategy &s)
 {
+  m_index += s->m_offset - m_profile[s->GetPlayer()->GetNumber()]->m_offset;
   m_profile[s->GetPlayer()->GetNumber()] = s;
 }
 
 Rational TreePureStrategyProfileRep::GetPayoff(int pl) const
 {
+  const GameTreePayoffs *table = 
+    dynamic_cast<GameTreeRep &>(*m_nfg).GetPayoffTable();
+  if (table) {
+    return table->GetPayoff(m_index, pl);
+  }
+
   PureBehavProfile behav(m_nfg);
   for (int i = 1; i <= m_nfg->NumPlayers(); i++) {
     GamePlayer player = m_nfg->GetPlayer(i);
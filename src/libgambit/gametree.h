@@ -28,6 +28,8 @@
 namespace Gambit {
 
 class GameTreeRep;
+class GameTreeNodeRep;
+class SnapshotReader;
 
 class GameTreeActionRep : public GameActionRep {
   friend class GameTreeRep;
@@ -61,6 +63,8 @@ class GameTreeInfosetRep : public GameInfosetRep {
   friend class GameTreeActionRep;
   friend class GamePlayerRep;
   friend class GameTreeNodeRep;
+  friend class GameTreeIndex;
+  friend class GameTreePayoffs;
   template <class T> friend class MixedBehavProfile;
 
 protected:
@@ -132,6 +136,8 @@ class GameTreeNodeRep : public GameNodeRep {
   friend class GameTreeInfosetRep;
   friend class GamePlayerRep;
   friend class PureBehavProfile;
+  friend class GameTreeIndex;
+  friend class GameTreePayoffs;
   template <class T> friend class MixedBehavProfile;
   
 protected:
@@ -194,17 +200,125 @@ public:
 };
 
 
+/// A flattened view of the structure of a tree, with the nodes listed
+/// in preorder in parallel arrays, so that quantities on the tree can
+/// be computed in linear sweeps rather than by recursion.  The node at
+/// position i is the node numbered i; the children of node i are at
+/// i+1, then at the end of the subtree of each child in turn.
+/// Information sets and actions, including those of the chance player,
+/// are numbered consecutively by player, information set and action.
+///
+/// The view also records structural properties which are otherwise
+/// found by searching the tree: the depth of each node, the members of
+/// each information set, which nodes are roots of subgames, and
+/// (computed on first request) whether the game has perfect recall.
+/// Since it lasts until the structure of the tree changes, these can
+/// then be looked up in constant time.
+class GameTreeIndex {
+  friend class GameTreeRep;
+private:
+  Array<GameTreeNodeRep *> m_nodes;
+  Array<int> m_parents, m_subtreeEnds, m_priorActions, m_nodeInfosets;
+  Array<int> m_depths;
+  Array<bool> m_subgameRoots;
+  Array<GameOutcomeRep *> m_outcomes;
+  Array<GameTreeInfosetRep *> m_infosets;
+  Array<GameTreeActionRep *> m_actions;
+  // The members of information set iset are at positions
+  // m_memberStarts[iset] up to m_memberStarts[iset+1] of m_members
+  Array<int> m_memberStarts, m_members;
+  // Zero if not yet known, 1 if the game has perfect recall, and -1 if
+  // not, in which case the pair of information sets showing this
+  mutable int m_perfectRecall, m_recallInfoset1, m_recallInfoset2;
+
+  /// Builds the index, numbering the nodes in preorder as it goes
+  GameTreeIndex(GameTreeNodeRep *p_root, GamePlayerRep *p_chance,
+		const Array<GamePlayerRep *> &p_players);
+
+  /// Finds whether the game has perfect recall
+  void ComputePerfectRecall(void) const;
+  /// Returns the action at node p_node leading towards p_successor
+  int GetActionTowards(int p_node, int p_successor) const;
+
+public:
+  /// @name Nodes
+  //@{
+  int NumNodes(void) const { return m_nodes.Length(); }
+  GameTreeNodeRep *GetNode(int i) const { return m_nodes[i]; }
+  /// Returns the position of the parent of node i (zero at the root)
+  int GetParent(int i) const { return m_parents[i]; }
+  /// Returns the position following the last node in the subtree at i
+  int GetSubtreeEnd(int i) const { return m_subtreeEnds[i]; }
+  /// Returns the index of the action leading to node i (zero at the root)
+  int GetPriorAction(int i) const { return m_priorActions[i]; }
+  /// Returns the index of the information set at node i (zero if terminal)
+  int GetNodeInfoset(int i) const { return m_nodeInfosets[i]; }
+  /// Returns the outcome at node i, or null if none
+  GameOutcomeRep *GetOutcome(int i) const { return m_outcomes[i]; }
+  /// Returns the number of moves from the root to node i
+  int GetDepth(int i) const { return m_depths[i]; }
+  /// Returns true if node i is node j or one of its descendants
+  bool IsSuccessor(int i, int j) const
+    { return (j <= i && i < m_subtreeEnds[j]); }
+  /// Returns true if node i is the root of a subgame
+  bool IsSubgameRoot(int i) const { return m_subgameRoots[i]; }
+  //@}
+
+  /// @name Information sets and actions
+  //@{
+  int NumInfosets(void) const { return m_infosets.Length(); }
+  GameTreeInfosetRep *GetInfoset(int iset) const { return m_infosets[iset]; }
+  /// Returns the number of members of the information set
+  int NumMembers(int iset) const
+    { return m_memberStarts[iset + 1] - m_memberStarts[iset]; }
+  /// Returns the position of the k'th member of the information set
+  int GetMember(int iset, int k) const
+    { return m_members[m_memberStarts[iset] + k - 1]; }
+  int NumActions(void) const { return m_actions.Length(); }
+  GameTreeActionRep *GetAction(int act) const { return m_actions[act]; }
+  //@}
+
+  /// Returns true if the game has perfect recall; if not, sets the
+  /// indices of a pair of information sets showing this
+  bool IsPerfectRecall(int &p_infoset1, int &p_infoset2) const;
+};
+
+/// The payoffs of the reduced strategic form of a tree, stored for
+/// every contingency in the order given by the strategy offsets.  They
+/// are computed in one pass over the contingencies, in which the part
+/// of the tree fixed by the strategies of the first players is walked
+/// once and shared by all contingencies extending them.
+class GameTreePayoffs {
+  friend class GameTreeRep;
+private:
+  int m_numPlayers;
+  Array<Rational> m_payoffs;
+
+  /// Computes the payoffs; the strategies of the tree must be built
+  GameTreePayoffs(const GameTreeRep &);
+
+public:
+  /// Returns the payoff to the player in the contingency with the index
+  const Rational &GetPayoff(long p_index, int pl) const
+    { return m_payoffs[(p_index - 1) * m_numPlayers + pl]; }
+};
+
 class GameTreeRep : public GameExplicitRep {
   friend class GameTreeNodeRep;
   friend class GameTreeInfosetRep;
+  friend class GameTreePayoffs;
 protected:
-  mutable bool m_computedValues;
+  mutable bool m_computedValues, m_canonical;
   GameTreeNodeRep *m_root;
   GamePlayerRep *m_chance;
+  mutable GameTreeIndex *m_index;
+  mutable GameTreePayoffs *m_payoffTable;
 
   /// @name Private auxiliary functions
   //@{
   void NumberNodes(GameTreeNodeRep *, int &);
+  /// Numbers the strategies, and sets their offsets into the payoff table
+  void IndexStrategies(void);
   //@}
 
 public: 
@@ -213,6 +327,7 @@ public:
   GameTreeRep(void);
   virtual ~GameTreeRep();
   virtual Game Copy(void) const;
+  virtual Game Copy(const GameNode &p_node) const;
   //@}
 
   /// @name General data access
@@ -247,6 +362,14 @@ public:
   virtual void ClearComputedValues(void) const;
   /// Have computed values been built?
   virtual bool HasComputedValues(void) const { return m_computedValues; }
+  /// Returns the flattened view of the tree, building it if necessary.
+  /// The view is discarded whenever the structure of the tree changes.
+  const GameTreeIndex &GetTreeIndex(void) const;
+  /// Returns the payoffs of the reduced strategic form, computing them
+  /// if necessary.  Returns null if the strategies have not been built,
+  /// or if there are too many contingencies to store.
+  const GameTreePayoffs *GetPayoffTable(void) const;
+  virtual void ClearComputedPayoffs(void) const;
   //@}
 
   /// @name Writing data files
@@ -254,6 +377,9 @@ public:
   virtual void WriteEfgFile(std::ostream &) const;
   virtual void WriteEfgFile(std::ostream &, const GameNode &p_node) const;
   virtual void WriteNfgFile(std::ostream &) const;
+  virtual void WriteSnapshotFile(std::ostream &) const;
+  /// Build a tree game from the body of a snapshot
+  static Game ReadSnapshot(SnapshotReader &);
   //@}
 
   /// @name Dimensions of the game
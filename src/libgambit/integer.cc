@@ -97,9 +97,6 @@ long lg(unsigned long x)
 #define MALLOC_MIN_OVERHEAD 4
 #endif
 
-static IntegerRep _ZeroRep = {1, 0, 1, {0}};
-static IntegerRep _OneRep = {1, 0, 1, {1}};
-static IntegerRep _MinusOneRep = {1, 0, 0, {1}};
 
 
 // utilities to extract and transfer bits
@@ -323,7 +320,7 @@ IntegerRep* Icopy_ulong(IntegerRep* old, unsigned long x)
   while (x != 0)
   {
     src[srclen++] = extract(x);
-    x = down(x);
+    x = x >> I_SHIFT;
   }
 
   IntegerRep* rep;
@@ -344,11 +341,13 @@ IntegerRep* Icopy_ulong(IntegerRep* old, unsigned long x)
 }
 
 // special case for zero -- it's worth it!
+// Results are always written in place, so these never share a static
+// representation, which other threads might be writing too.
 
 IntegerRep* Icopy_zero(IntegerRep* old)
 {
   if (old == 0 || STATIC_IntegerRep(old))
-    return &_ZeroRep;
+    old = Inew(0);
 
   old->len = 0;
   old->sgn = I_POSITIVE;
@@ -363,7 +362,7 @@ IntegerRep* Icopy_one(IntegerRep* old, int newsgn)
   if (old == 0 || 1 > old->sz)
   {
     if (old != 0 && !STATIC_IntegerRep(old)) delete old;
-    return newsgn==I_NEGATIVE ? &_MinusOneRep : &_OneRep;
+    old = Inew(1);
   }
 
   old->sgn = newsgn;
@@ -488,22 +487,184 @@ int Iisdouble(const IntegerRep* rep)
   return 1;
 }
 
+// test whether the value can be held in a machine word.
+// The most negative long long is excluded, so that negating
+// a word never overflows.
+
+#define SHORT_PER_WORD  ((unsigned)(sizeof(long long) / sizeof(short)))
+
+int Iisword(const IntegerRep* rep)
+{
+  unsigned int l = rep->len;
+  while (l > 0 && rep->s[l - 1] == 0) --l;
+  if (l < SHORT_PER_WORD)
+    return 1;
+  else if (l > SHORT_PER_WORD)
+    return 0;
+  else
+    return (unsigned)(rep->s[SHORT_PER_WORD - 1]) < (unsigned)(I_MINNUM);
+}
+
+// convert to a word; the value must satisfy Iisword()
+
+long long Itoword(const IntegerRep* rep)
+{
+  unsigned long long a = 0;
+  for (int i = rep->len - 1; i >= 0; --i)
+    a = (a << I_SHIFT) | rep->s[i];
+  return (rep->sgn == I_POSITIVE) ? (long long) a : -((long long) a);
+}
+
+// utilities for values held in machine words
+
+inline static int Ifitsword(long long x)
+{
+  return x != LLONG_MIN;
+}
+
+inline static unsigned long long Iword_abs(long long x)
+{
+  return (x < 0) ? -((unsigned long long) x) : (unsigned long long) x;
+}
+
+inline static long long Iword_sign(long long x, unsigned long long a)
+{
+  return (x < 0) ? -((long long) a) : (long long) a;
+}
+
+// present a word as a static IntegerRep, using buf as storage
+
+static const IntegerRep* Iword(long long x, IntegerWordRep& buf)
+{
+  unsigned long long a = Iword_abs(x);
+  buf.len = 0;
+  buf.sz = 0;
+  buf.sgn = (x >= 0) ? I_POSITIVE : I_NEGATIVE;
+  while (a != 0)
+  {
+    buf.s[buf.len++] = (unsigned short) (a & I_MAXNUM);
+    a >>= I_SHIFT;
+  }
+  return (const IntegerRep*) &buf;
+}
+
+// overflow-checked operations on words.  Each returns 0, leaving r
+// unchanged, if the result cannot be held in a word.
+
+inline static int Iword_add(long long x, long long y, long long& r)
+{
+  if ((y > 0) ? (x > LLONG_MAX - y) : (x < -LLONG_MAX - y))
+    return 0;
+  r = x + y;
+  return 1;
+}
+
+inline static int Iword_mul(long long x, long long y, long long& r)
+{
+#ifdef __SIZEOF_INT128__
+  __int128 p = (__int128) x * y;
+  if (p > LLONG_MAX || p < -LLONG_MAX)
+    return 0;
+  r = (long long) p;
+#else
+  unsigned long long a = Iword_abs(x), b = Iword_abs(y);
+  if (a != 0 && b > (unsigned long long) LLONG_MAX / a)
+    return 0;
+  r = Iword_sign(((x < 0) != (y < 0)) ? -1 : 1, a * b);
+#endif
+  return 1;
+}
+
+// shifts act on the magnitude, as for IntegerReps
+
+static int Iword_shift(long long x, long long y, long long& r)
+{
+  unsigned long long a = Iword_abs(x);
+  if (a == 0)
+    ;
+  else if (y >= 0)
+  {
+    if (y >= (long long) (sizeof(long long) * CHAR_BIT - 1) || 
+        (a >> (sizeof(long long) * CHAR_BIT - 1 - y)) != 0)
+      return 0;
+    a <<= y;
+  }
+  else if (y <= -(long long) (sizeof(long long) * CHAR_BIT))
+    a = 0;
+  else
+    a >>= -y;
+  r = Iword_sign(x, a);
+  return 1;
+}
+
+static int Iword_power(long long x, long y, long long& r)
+{
+  if (y == 0 || x == 1 || x == -1)
+    r = (x < 0 && (y & 1)) ? -1 : 1;
+  else if (x == 0 || y < 0)
+    r = 0;
+  else
+  {
+    long long p = 1, b = x;
+    for (;;)
+    {
+      if ((y & 1) && !Iword_mul(p, b, p))
+        return 0;
+      if ((y >>= 1) == 0)
+        break;
+      if (!Iword_mul(b, b, b))
+        return 0;
+    }
+    r = p;
+  }
+  return 1;
+}
+
+static long long Iword_gcd(long long x, long long y)
+{
+  unsigned long long a = Iword_abs(x), b = Iword_abs(y);
+  while (b != 0)
+  {
+    unsigned long long t = a % b;
+    a = b;
+    b = t;
+  }
+  return (long long) a;
+}
+
 // real division of num / den
 
 double ratio(const Integer& num, const Integer& den)
 {
   Integer q, r;
   divide(num, den, q, r);
+
+  // when the quotient and denominator are exactly representable,
+  // the loop below computes exactly this
+  const long long exact = (long long) 1 << DBL_MANT_DIG;
+  if (q.rep == 0 && den.rep == 0 && r.rep == 0 &&
+      Iword_abs(q.word) < (unsigned long long) exact && 
+      Iword_abs(den.word) < (unsigned long long) exact)
+  {
+    double d1 = (double) q.word;
+    if (r.word == 0)
+      return d1;
+    return d1 + (double) r.word / (double) Iword_abs(den.word);
+  }
+
   double d1 = q.as_double();
  
   if (d1 >= DBL_MAX || d1 <= -DBL_MAX || sign(r) == 0)
     return d1;
   else      // use as much precision as available for fractional part
   {
+    IntegerWordRep dbuf, rbuf;
+    const IntegerRep* dr = den.GetRep(dbuf);
+    const IntegerRep* rr = r.GetRep(rbuf);
     double  d2 = 0.0;
     double  d3 = 0.0; 
     int cont = 1;
-    for (int i = den.rep->len - 1; i >= 0 && cont; --i)
+    for (int i = dr->len - 1; i >= 0 && cont; --i)
     {
 		unsigned short a = (unsigned short) (I_RADIX >> 1);
       while (a != 0)
@@ -515,13 +676,13 @@ double ratio(const Integer& num, const Integer& den)
         }
 
         d2 *= 2.0;
-        if (den.rep->s[i] & a)
+        if (dr->s[i] & a)
           d2 += 1.0;
 
-        if (i < r.rep->len)
+        if (i < rr->len)
         {
           d3 *= 2.0;
-          if (r.rep->s[i] & a)
+          if (rr->s[i] & a)
             d3 += 1.0;
         }
 
@@ -1262,6 +1423,7 @@ IntegerRep* div(const IntegerRep* x, const IntegerRep* y, IntegerRep* q)
       yy = (IntegerRep*)y;
       r = Icalloc(r, xl + 1);
       scpy(x->s, r->s, xl);
+      r->sgn = xsgn;
     }
 
     int ql = xl - yl + 1;
@@ -1348,97 +1510,38 @@ IntegerRep* div(const IntegerRep* x, long y, IntegerRep* q)
 
 void divide(const Integer& Ix, long y, Integer& Iq, long& rem)
 {
-  const IntegerRep* x = Ix.rep;
-  nonnil(x);
-  IntegerRep* q = Iq.rep;
-  int xl = x->len;
-  // if (y == 0) (*lib_error_handler)("Integer", "attempted division by zero");
-  assert(y != 0);
-
-  unsigned short ys[SHORT_PER_LONG];
-  unsigned long u;
-  int ysgn = y >= 0;
-  if (ysgn)
-    u = y;
-  else
-    u = -y;
-  int yl = 0;
-  while (u != 0)
+  if (Ix.rep == 0 && y != 0)
   {
-    ys[yl++] = extract(u);
-    u = down(u);
+    long long qw = Ix.word / y;
+    rem = (long) (Ix.word % y);
+    Iq.SetWord(qw);
+    return;
   }
 
-  int comp = xl - yl;
-  if (comp == 0) comp = docmp(x->s, ys, xl);
-
-  int xsgn = x->sgn;
-  int samesign = xsgn == ysgn;
-
-  if (comp < 0)
-  {
-    rem = Itolong(x);
-    q = Icopy_zero(q);
-  }
-  else if (comp == 0)
-  {
-    q = Icopy_one(q, samesign);
-    rem = 0;
-  }
-  else if (yl == 1)
-  {
-    q = Icopy(q, x);
-    rem = unscale(q->s, q->len, ys[0], q->s);
-  }
-  else
-  {
-    IntegerRep* r  = 0;
-	 unsigned short prescale = (unsigned short) (I_RADIX / (1 + ys[yl - 1]));
-    if (prescale != 1)
-    {
-      unsigned long prod = (unsigned long)prescale * (unsigned long)ys[0];
-      ys[0] = extract(prod);
-      prod = down(prod) + (unsigned long)prescale * (unsigned long)ys[1];
-      ys[1] = extract(prod);
-      r = multiply(x, ((long)prescale & I_MAXNUM), r);
-    }
-    else
-    {
-      r = Icalloc(r, xl + 1);
-      scpy(x->s, r->s, xl);
-    }
-
-    int ql = xl - yl + 1;
-      
-    q = Icalloc(q, ql);
-    
-    do_divide(r->s, ys, yl, q->s, ql);
-
-    if (prescale != 1)
-    {
-      Icheck(r);
-      unscale(r->s, r->len, prescale, r->s);
-    }
-    Icheck(r);
-    rem = Itolong(r);
-    if (!STATIC_IntegerRep(r)) delete r;
-  }
-  rem = abs(rem).as_long();
-  if (xsgn == I_NEGATIVE) rem = -rem;
-  q->sgn = samesign;
-  Icheck(q);
-  Iq.rep = q;
+  // the remainder is smaller in magnitude than y, so fits in a long
+  Integer Ir;
+  divide(Ix, Integer(y), Iq, Ir);
+  rem = Ir.as_long();
 }
 
 
 void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
 {
-  const IntegerRep* x = Ix.rep;
+  if (Ix.rep == 0 && Iy.rep == 0 && Iy.word != 0)
+  {
+    long long qw = Ix.word / Iy.word, rw = Ix.word % Iy.word;
+    Iq.SetWord(qw);
+    Ir.SetWord(rw);
+    return;
+  }
+
+  IntegerWordRep xbuf, ybuf;
+  const IntegerRep* x = Ix.GetRep(xbuf);
   nonnil(x);
-  const IntegerRep* y = Iy.rep;
+  const IntegerRep* y = Iy.GetRep(ybuf);
   nonnil(y);
-  IntegerRep* q = Iq.rep;
-  IntegerRep* r = Ir.rep;
+  IntegerRep* q = Iq.ReleaseRep();
+  IntegerRep* r = Ir.ReleaseRep();
 
   int xl = x->len;
   int yl = y->len;
@@ -1485,6 +1588,7 @@ void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
       yy = (IntegerRep*)y;
       r = Icalloc(r, xl + 1);
       scpy(x->s, r->s, xl);
+      r->sgn = xsgn;
     }
 
     int ql = xl - yl + 1;
@@ -1501,9 +1605,9 @@ void divide(const Integer& Ix, const Integer& Iy, Integer& Iq, Integer& Ir)
   }
   q->sgn = samesign;
   Icheck(q);
-  Iq.rep = q;
+  Iq.SetRep(q);
   Icheck(r);
-  Ir.rep = r;
+  Ir.SetRep(r);
 }
 
 IntegerRep* mod(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
@@ -1543,6 +1647,7 @@ IntegerRep* mod(const IntegerRep* x, const IntegerRep* y, IntegerRep* r)
       yy = (IntegerRep*)y;
       r = Icalloc(r, xl + 1);
       scpy(x->s, r->s, xl);
+      r->sgn = xsgn;
     }
       
     do_divide(r->s, yy->s, yl, 0, xl - yl + 1);
@@ -1849,17 +1954,28 @@ IntegerRep*  Compl(const IntegerRep* src, IntegerRep* r)
   return r;
 }
 
+#define BITS_PER_WORD  ((long)(sizeof(long long) * CHAR_BIT))
+
 void (setbit)(Integer& x, long b)
 {
   if (b >= 0)
   {
+    if (x.rep == 0 && b < BITS_PER_WORD - 1)
+    {
+      x.word = Iword_sign(x.word, 
+			  Iword_abs(x.word) | ((unsigned long long) 1 << b));
+      return;
+    }
+    IntegerWordRep xbuf;
+    IntegerRep* r = (x.rep != 0) ? x.ReleaseRep() : Icopy(0, x.GetRep(xbuf));
 	 int bw = (int) ((unsigned long)b / I_SHIFT);
 	 int sw = (int) ((unsigned long)b % I_SHIFT);
-    int xl = x.rep ? x.rep->len : 0;
+    int xl = r->len;
     if (xl <= bw)
-      x.rep = Iresize(x.rep, calc_len(xl, bw+1, 0));
-    x.rep->s[bw] |= (1 << sw);
-    Icheck(x.rep);
+      r = Iresize(r, calc_len(xl, bw+1, 0));
+    r->s[bw] |= (1 << sw);
+    Icheck(r);
+    x.SetRep(r);
   }
 }
 
@@ -1868,21 +1984,30 @@ void clearbit(Integer& x, long b)
   if (b >= 0)
     {
       if (x.rep == 0)
-	x.rep = &_ZeroRep;
+	{
+	  if (b < BITS_PER_WORD - 1)
+	    x.word = Iword_sign(x.word,
+				Iword_abs(x.word) & ~((unsigned long long) 1 << b));
+	}
       else
 	{
+	  IntegerRep* r = x.ReleaseRep();
 	  int bw = (int) ((unsigned long)b / I_SHIFT);
 	  int sw = (int) ((unsigned long)b % I_SHIFT);
-	  if (x.rep->len > bw)
-	    x.rep->s[bw] &= ~(1 << sw);
+	  if (r->len > bw)
+	    r->s[bw] &= ~(1 << sw);
+	  Icheck(r);
+	  x.SetRep(r);
 	}
-    Icheck(x.rep);
   }
 }
 
 int testbit(const Integer& x, long b)
 {
-  if (x.rep != 0 && b >= 0)
+  if (x.rep == 0)
+    return (b >= 0 && b < BITS_PER_WORD - 1 && 
+	    ((Iword_abs(x.word) >> b) & 1) != 0);
+  else if (b >= 0)
   {
 	 int bw = (int) ((unsigned long)b / I_SHIFT);
 	 int sw = (int) ((unsigned long)b % I_SHIFT);
@@ -2195,7 +2320,7 @@ std::string Itoa(const IntegerRep *x, int base, int width)
 
 std::ostream &operator<<(std::ostream &s, const Integer &y)
 {
-  return s << Itoa(y.rep);
+  return s << Itoa(y);
 }
 
 std::string cvtItoa(const IntegerRep *x, std::string fmt, int& fmtlen, int base, int showbase,
@@ -2294,7 +2419,7 @@ std::istream &operator>>(std::istream &s, Integer& y)
 {
   char sgn = 0;
   char ch;
-  y.rep = Icopy_zero(y.rep);
+  y = 0L;
 
   do  {
 	 s.get(ch);
@@ -2333,7 +2458,12 @@ std::istream &operator>>(std::istream &s, Integer& y)
 
 int Integer::OK() const
 {
-  if (rep != 0)
+  if (rep == 0)
+    {
+      if (Ifitsword(word))
+	return 1;
+    }
+  else
 	 {
       int l = rep->len;
       int s = rep->sgn;
@@ -2342,6 +2472,7 @@ int Integer::OK() const
       Icheck(rep);                  // and correctly adjusted
       v &= rep->len == l;
       v &= rep->sgn == s;
+      v &= !Iisword(rep);           // and not small enough for a word
       if (v)
 	  return v;
     }
@@ -2360,178 +2491,394 @@ void Integer::error(const char* msg) const
 // The following were moved from the header file to stop BC from squealing
 // endless quantities of warnings
 
-Integer::Integer() :rep(&_ZeroRep) {}
+const IntegerRep* Integer::GetRep(IntegerWordRep& buf) const
+{
+  return (rep != 0) ? rep : Iword(word, buf);
+}
 
-Integer::Integer(IntegerRep* r) :rep(r) {}
+void Integer::SetRep(IntegerRep* r)
+{
+  if (rep != 0 && rep != r && !STATIC_IntegerRep(rep)) delete rep;
+  if (Iisword(r))
+  {
+    word = Itoword(r);
+    if (!STATIC_IntegerRep(r)) delete r;
+    rep = 0;
+  }
+  else
+  {
+    rep = r;
+    word = 0;
+  }
+}
+
+void Integer::SetWord(long long x)
+{
+  if (rep != 0 && !STATIC_IntegerRep(rep)) delete rep;
+  rep = 0;
+  word = x;
+}
 
-Integer::Integer(int y) :rep(Icopy_long(0, (long)y)) {}
+Integer::Integer() :rep(0), word(0) {}
 
-Integer::Integer(long y) :rep(Icopy_long(0, y)) {}
+Integer::Integer(IntegerRep* r) :rep(0), word(0) { SetRep(r); }
 
-Integer::Integer(unsigned long y) :rep(Icopy_ulong(0, y)) {}
+Integer::Integer(int y) :rep(0), word(y) {}
 
-Integer::Integer(const Integer&  y) :rep(Icopy(0, y.rep)) {}
+Integer::Integer(long y) :rep(0), word(y) 
+{
+  if (!Ifitsword(y)) 
+  {
+    rep = Icopy_long(0, y);
+    word = 0;
+  }
+}
+
+Integer::Integer(unsigned long y) :rep(0), word((long long) y) 
+{
+  if (y > (unsigned long long) LLONG_MAX)
+  {
+    rep = Icopy_ulong(0, y);
+    word = 0;
+  }
+}
+
+Integer::Integer(const Integer&  y) 
+  :rep((y.rep != 0) ? Icopy(0, y.rep) : 0), word(y.word) {}
 
 Integer::~Integer() { if (rep && !STATIC_IntegerRep(rep)) delete rep; }
 
 Integer &Integer::operator=(const Integer &y)
 {
-  rep = Icopy(rep, y.rep);
+  if (y.rep != 0)
+    rep = Icopy(rep, y.rep);
+  else
+    SetWord(y.word);
   return *this;
 }
 
 Integer &Integer::operator=(long y)
 {
-  rep = Icopy_long(rep, y); 
+  if (Ifitsword(y))
+    SetWord(y);
+  else
+    rep = Icopy_long(rep, y); 
   return *this;
 }
 
 int Integer::initialized() const
 {
-  return rep != 0;
+  return rep != 0 || Ifitsword(word);
 }
 
-// procedural versions
+// procedural versions.  Each tries the operation on words first;
+// if an operand is a bignum, or the result overflows, the IntegerRep
+// routine is used instead.  Long operands are passed to the routines
+// as IntegerReps, since the routines taking longs assume that a
+// long is at most two digits.
 
 int compare(const Integer& x, const Integer& y)
 {
-  return compare(x.rep, y.rep);
+  if (x.rep == 0 && y.rep == 0)
+    return (x.word < y.word) ? -1 : (x.word > y.word);
+  IntegerWordRep xbuf, ybuf;
+  return compare(x.GetRep(xbuf), y.GetRep(ybuf));
 }
 
 int ucompare(const Integer& x, const Integer& y)
 {
-  return ucompare(x.rep, y.rep);
+  if (x.rep == 0 && y.rep == 0)
+  {
+    unsigned long long a = Iword_abs(x.word), b = Iword_abs(y.word);
+    return (a < b) ? -1 : (a > b);
+  }
+  IntegerWordRep xbuf, ybuf;
+  return ucompare(x.GetRep(xbuf), y.GetRep(ybuf));
 }
 
 int compare(const Integer& x, long y)
 {
-  return compare(x.rep, y);
+  if (x.rep == 0)
+    return (x.word < y) ? -1 : (x.word > y);
+  IntegerWordRep ybuf;
+  return compare(x.rep, Iword(y, ybuf));
 }
 
 int ucompare(const Integer& x, long y)
 {
-  return ucompare(x.rep, y);
+  if (x.rep == 0)
+  {
+    unsigned long long a = Iword_abs(x.word), b = Iword_abs(y);
+    return (a < b) ? -1 : (a > b);
+  }
+  IntegerWordRep ybuf;
+  return ucompare(x.rep, Iword(y, ybuf));
 }
 
 int compare(long x, const Integer& y)
 {
-  return -compare(y.rep, x);
+  return -compare(y, x);
 }
 
 int ucompare(long x, const Integer& y)
 {
-  return -ucompare(y.rep, x);
+  return -ucompare(y, x);
 }
 
 void  add(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, y.rep, 0, dest.rep);
+  long long r;
+  if (x.rep == 0 && y.rep == 0 && Iword_add(x.word, y.word, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    const IntegerRep* yr = y.GetRep(ybuf);
+    dest.SetRep(add(xr, 0, yr, 0, dest.ReleaseRep()));
+  }
 }
 
 void  sub(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, y.rep, 1, dest.rep);
+  long long r;
+  if (x.rep == 0 && y.rep == 0 && Iword_add(x.word, -y.word, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    const IntegerRep* yr = y.GetRep(ybuf);
+    dest.SetRep(add(xr, 0, yr, 1, dest.ReleaseRep()));
+  }
 }
 
 void  mul(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = multiply(x.rep, y.rep, dest.rep);
+  long long r;
+  if (x.rep == 0 && y.rep == 0 && Iword_mul(x.word, y.word, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    const IntegerRep* yr = y.GetRep(ybuf);
+    dest.SetRep(multiply(xr, yr, dest.ReleaseRep()));
+  }
 }
 
 void  div(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = div(x.rep, y.rep, dest.rep);
+  if (x.rep == 0 && y.rep == 0 && y.word != 0)
+    dest.SetWord(x.word / y.word);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    const IntegerRep* yr = y.GetRep(ybuf);
+    dest.SetRep(div(xr, yr, dest.ReleaseRep()));
+  }
 }
 
 void  mod(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = mod(x.rep, y.rep, dest.rep);
+  if (x.rep == 0 && y.rep == 0 && y.word != 0)
+    dest.SetWord(x.word % y.word);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    const IntegerRep* yr = y.GetRep(ybuf);
+    dest.SetRep(mod(xr, yr, dest.ReleaseRep()));
+  }
 }
 
 void  lshift(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y.rep, 0, dest.rep);
+  long long r;
+  if (x.rep == 0 && y.rep == 0 && Iword_shift(x.word, y.word, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    const IntegerRep* yr = y.GetRep(ybuf);
+    dest.SetRep(lshift(xr, yr, 0, dest.ReleaseRep()));
+  }
 }
 
 void  rshift(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y.rep, 1, dest.rep);
+  long long r;
+  if (x.rep == 0 && y.rep == 0 && Iword_shift(x.word, -y.word, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    const IntegerRep* yr = y.GetRep(ybuf);
+    dest.SetRep(lshift(xr, yr, 1, dest.ReleaseRep()));
+  }
 }
 
 void  pow(const Integer& x, const Integer& y, Integer& dest)
 {
-  dest.rep = power(x.rep, Itolong(y.rep), dest.rep); // not incorrect
+  pow(x, y.as_long(), dest); // not incorrect
 }
 
 void  add(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, y, dest.rep);
+  long long r;
+  if (x.rep == 0 && Ifitsword(y) && Iword_add(x.word, y, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    dest.SetRep(add(xr, 0, Iword(y, ybuf), 0, dest.ReleaseRep()));
+  }
 }
 
 void  sub(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = add(x.rep, 0, -y, dest.rep);
+  long long r;
+  if (x.rep == 0 && Ifitsword(y) && Iword_add(x.word, -y, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    dest.SetRep(add(xr, 0, Iword(y, ybuf), 1, dest.ReleaseRep()));
+  }
 }
 
 void  mul(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = multiply(x.rep, y, dest.rep);
+  long long r;
+  if (x.rep == 0 && Ifitsword(y) && Iword_mul(x.word, y, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    dest.SetRep(multiply(xr, Iword(y, ybuf), dest.ReleaseRep()));
+  }
 }
 
 void  div(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = div(x.rep, y, dest.rep);
+  if (x.rep == 0 && y != 0)
+    dest.SetWord(x.word / y);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    dest.SetRep(div(xr, Iword(y, ybuf), dest.ReleaseRep()));
+  }
 }
 
 void  mod(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = mod(x.rep, y, dest.rep);
+  if (x.rep == 0 && y != 0)
+    dest.SetWord(x.word % y);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    dest.SetRep(mod(xr, Iword(y, ybuf), dest.ReleaseRep()));
+  }
 }
 
 
 void  lshift(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, y, dest.rep);
+  long long r;
+  if (x.rep == 0 && Iword_shift(x.word, y, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    dest.SetRep(lshift(xr, y, dest.ReleaseRep()));
+  }
 }
 
 void  rshift(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = lshift(x.rep, -y, dest.rep);
+  long long r;
+  if (x.rep == 0 && Ifitsword(y) && Iword_shift(x.word, -y, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    dest.SetRep(lshift(xr, -y, dest.ReleaseRep()));
+  }
 }
 
 void  pow(const Integer& x, long y, Integer& dest)
 {
-  dest.rep = power(x.rep, y, dest.rep);
+  long long r;
+  if (x.rep == 0 && Iword_power(x.word, y, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf;
+    const IntegerRep* xr = x.GetRep(xbuf);
+    dest.SetRep(power(xr, y, dest.ReleaseRep()));
+  }
 }
 
 void abs(const Integer& x, Integer& dest)
 {
-  dest.rep = abs(x.rep, dest.rep);
+  if (x.rep == 0)
+    dest.SetWord((x.word < 0) ? -x.word : x.word);
+  else
+  {
+    const IntegerRep* xr = x.rep;
+    dest.SetRep(abs(xr, dest.ReleaseRep()));
+  }
 }
 
 void negate(const Integer& x, Integer& dest)
 {
-  dest.rep = negate(x.rep, dest.rep);
+  if (x.rep == 0)
+    dest.SetWord(-x.word);
+  else
+  {
+    const IntegerRep* xr = x.rep;
+    dest.SetRep(negate(xr, dest.ReleaseRep()));
+  }
 }
 
 void complement(const Integer& x, Integer& dest)
 {
-  dest.rep = Compl(x.rep, dest.rep);
+  IntegerWordRep xbuf;
+  const IntegerRep* xr = x.GetRep(xbuf);
+  dest.SetRep(Compl(xr, dest.ReleaseRep()));
 }
 
 void  add(long x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(y.rep, 0, x, dest.rep);
+  add(y, x, dest);
 }
 
 void  sub(long x, const Integer& y, Integer& dest)
 {
-  dest.rep = add(y.rep, 1, x, dest.rep);
+  long long r;
+  if (y.rep == 0 && Ifitsword(x) && Iword_add(x, -y.word, r))
+    dest.SetWord(r);
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    const IntegerRep* yr = y.GetRep(ybuf);
+    dest.SetRep(add(Iword(x, xbuf), 0, yr, 1, dest.ReleaseRep()));
+  }
 }
 
 void  mul(long x, const Integer& y, Integer& dest)
 {
-  dest.rep = multiply(y.rep, x, dest.rep);
+  mul(y, x, dest);
 }
 
 // operator versions
@@ -2697,28 +3044,60 @@ void Integer::negate()
 
 int sign(const Integer& x)
 {
+  if (x.rep == 0)
+    return (x.word < 0) ? -1 : (x.word > 0);
   return (x.rep->len == 0) ? 0 : ( (x.rep->sgn == 1) ? 1 : -1 );
 }
 
 int even(const Integer& y)
 {
+  if (y.rep == 0)
+    return !(y.word & 1);
   return y.rep->len == 0 || !(y.rep->s[0] & 1);
 }
 
 int odd(const Integer& y)
 {
+  if (y.rep == 0)
+    return (y.word & 1) != 0;
   return y.rep->len > 0 && (y.rep->s[0] & 1);
 }
 
 std::string Itoa(const Integer& y, int base, int width)
 {
-  return Itoa(y.rep, base, width);
+  if (y.rep == 0 && base == 10 && width == 0)
+  {
+    char buf[3 * sizeof(long long) + 2];
+    char* p = buf + sizeof(buf);
+    unsigned long long a = Iword_abs(y.word);
+    do
+    {
+      *--p = (char) ('0' + a % 10);
+      a /= 10;
+    } while (a != 0);
+    if (y.word < 0)
+      *--p = '-';
+    return std::string(p, buf + sizeof(buf));
+  }
+  IntegerWordRep ybuf;
+  return Itoa(y.GetRep(ybuf), base, width);
 }
 
 
 
 long lg(const Integer& x) 
 {
+  if (x.rep == 0)
+  {
+    unsigned long long a = Iword_abs(x.word);
+    long l = (a == 0) ? 0 : -1;
+    while (a != 0)
+    {
+      a >>= 1;
+      ++l;
+    }
+    return l;
+  }
   return lg(x.rep);
 }
 
@@ -2870,17 +3249,53 @@ Integer Integer::operator-(void) const
 Integer  atoI(const char* s, int base) 
 {
   Integer r;
-  r.rep = atoIntegerRep(s, base);
+  r.SetRep(atoIntegerRep(s, base));
   return r;
 }
 
 Integer  gcd(const Integer& x, const Integer& y)
 {
   Integer r;
-  r.rep = gcd(x.rep, y.rep);
+  if (x.rep == 0 && y.rep == 0)
+    r.SetWord(Iword_gcd(x.word, y.word));
+  else
+  {
+    IntegerWordRep xbuf, ybuf;
+    r.SetRep(gcd(x.GetRep(xbuf), y.GetRep(ybuf)));
+  }
   return r;
 }
 
+int Integer::fits_in_long() const
+{
+  if (rep == 0)
+    return word >= LONG_MIN && word <= LONG_MAX;
+  return Iislong(rep);
+}
+
+int Integer::fits_in_double() const
+{
+  if (rep == 0)
+    return 1;
+  return Iisdouble(rep);
+}
+
+long Integer::as_long() const
+{
+  if (rep == 0 && word >= LONG_MIN && word <= LONG_MAX)
+    return (long) word;
+  IntegerWordRep buf;
+  return Itolong(GetRep(buf));
+}
+
+double Integer::as_double() const
+{
+  if (rep == 0 && Iword_abs(word) < ((unsigned long long) 1 << DBL_MANT_DIG))
+    return (double) word;
+  IntegerWordRep buf;
+  return Itodouble(GetRep(buf));
+}
+
 
 
 
@@ -47,6 +47,16 @@ struct IntegerRep                    // internal Integer representations
 // and should not be deleted by an Integer destructor.
 #define STATIC_IntegerRep(rep) ((rep)->sz==0)
 
+// Static storage large enough to present a machine-word value as an
+// IntegerRep, for passing small values to the IntegerRep routines
+struct IntegerWordRep
+{
+  unsigned short  len;
+  unsigned short  sz;
+  short           sgn;
+  unsigned short  s[sizeof(long long) / sizeof(short)];
+};
+
 extern IntegerRep*  Ialloc(IntegerRep*, const unsigned short *, int, int, int);
 extern IntegerRep*  Icalloc(IntegerRep*, int);
 extern IntegerRep*  Icopy_ulong(IntegerRep*, unsigned long);
@@ -82,12 +92,40 @@ extern IntegerRep*  atoIntegerRep(const char* s, int base = 10);
 extern long     Itolong(const IntegerRep*);
 extern double   Itodouble(const IntegerRep*);
 extern int      Iislong(const IntegerRep*);
+extern int      Iisword(const IntegerRep*);
+extern long long Itoword(const IntegerRep*);
 extern int      Iisdouble(const IntegerRep*);
 extern long     lg(const IntegerRep*);
 
+/// An arbitrary-precision integer.
+///
+/// Values whose magnitude fits in a machine word (a long long) are
+/// stored inline, and arithmetic on them is done with overflow-checked
+/// machine operations.  Only when a result overflows is the value
+/// promoted to the arbitrary-precision IntegerRep; results of bignum
+/// operations which fit in a word are demoted again.
 class Integer {
 protected:
+  /// The arbitrary-precision representation; null if the value is
+  /// held in 'word'
   IntegerRep *rep;
+  /// The value, if it fits in a machine word.  The most negative
+  /// long long is excluded, so negation never overflows.
+  long long word;
+
+  /// @name Managing the representation
+  //@{
+  /// Returns the value as an IntegerRep, using p_buffer as storage
+  /// if the value is held in a word
+  const IntegerRep *GetRep(IntegerWordRep &p_buffer) const;
+  /// Relinquishes ownership of the bignum representation, if any,
+  /// so it can be reused as the destination of an IntegerRep routine
+  IntegerRep *ReleaseRep(void) { IntegerRep *r = rep; rep = 0; return r; }
+  /// Takes ownership of p_rep, storing the value in a word if it fits
+  void SetRep(IntegerRep *p_rep);
+  /// Sets the value to p_value, which must not be the most negative word
+  void SetWord(long long p_value);
+  //@}
 
 public:
   /// @name Lifecycle
@@ -221,11 +259,15 @@ public:
 
   // coercion & conversion
 
-  int             fits_in_long() const { return Iislong(rep); }
-  int             fits_in_double() const { return Iisdouble(rep); }
+  int             fits_in_long() const;
+  int             fits_in_double() const;
+  /// Returns true if the value is stored inline in a machine word
+  bool            fits_in_word() const { return rep == 0; }
 
-  long		  as_long() const { return Itolong(rep); }
-  double	  as_double() const { return Itodouble(rep); }
+  long		  as_long() const;
+  double	  as_double() const;
+  /// Returns the value, which must satisfy fits_in_word()
+  long long       as_word() const { return word; }
 
   friend std::string    Itoa(const Integer& x, int base = 10, int width = 0);
   friend Integer  atoI(const char* s, int base = 10);
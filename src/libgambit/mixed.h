@@ -219,6 +219,21 @@ public:
   /// implements a positive penalty for profiles which are not on the
   /// simplotope (useful for penalty-function minimization methods).
   T GetLiapValue(void) const;
+
+  /// \brief Computes the payoff of a best response for each player
+  ///
+  /// Returns the payoff to each player of the best response to the
+  /// profile, over all strategies in the game.  For extensive games
+  /// with perfect recall, this is computed on the tree, with the
+  /// players computed concurrently on the given number of threads
+  /// (one per processor if zero).
+  Vector<T> GetBestResponseValues(int p_threads = 1) const;
+
+  /// \brief Computes the exploitability of the profile
+  ///
+  /// Returns the sum over players of the gain from playing a best
+  /// response to the profile.  This is zero exactly at Nash equilibria.
+  T GetExploitability(int p_threads = 1) const;
   //@}
 };
 
@@ -0,0 +1,280 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/number.cc
+// Implementation of class for storing numerical data in a game
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cctype>
+#include <climits>
+
+#include "libgambit.h"
+
+namespace Gambit {
+
+//========================================================================
+//                   Machine-word arithmetic helpers
+//========================================================================
+
+namespace {
+
+/// Values at or above this magnitude may not be represented exactly
+/// as doubles; conversions of these go through Rational so the result
+/// agrees exactly with the arbitrary-precision conversion.
+const long long c_exactDouble = 9007199254740992LL;   // 2^53
+
+/// Sets p_value to 10 * p_value + p_digit; returns false on overflow
+inline bool AppendDigit(long long &p_value, int p_digit)
+{
+  if (p_value > (LLONG_MAX - p_digit) / 10)  return false;
+  p_value = 10 * p_value + p_digit;
+  return true;
+}
+
+/// Sets p_result to p_x * p_y for nonnegative arguments;
+/// returns false on overflow
+inline bool Multiply(long long p_x, long long p_y, long long &p_result)
+{
+  if (p_y != 0 && p_x > LLONG_MAX / p_y)  return false;
+  p_result = p_x * p_y;
+  return true;
+}
+
+/// Sets p_result to 10^p_exp; returns false on overflow
+inline bool PowerOfTen(int p_exp, long long &p_result)
+{
+  p_result = 1;
+  for (int i = 0; i < p_exp; i++) {
+    if (!Multiply(p_result, 10, p_result))  return false;
+  }
+  return true;
+}
+
+long long GreatestCommonDivisor(long long p_x, long long p_y)
+{
+  if (p_x < 0)  p_x = -p_x;
+  while (p_y != 0) {
+    long long r = p_x % p_y;
+    p_x = p_y;
+    p_y = r;
+  }
+  return p_x;
+}
+
+/// Converts to Integer, via the text form if the value does not
+/// fit in a long
+Integer ToInteger(long long p_value)
+{
+  if (p_value >= LONG_MIN && p_value <= LONG_MAX) {
+    return Integer((long) p_value);
+  }
+  return Integer(atoIntegerRep(lexical_cast<std::string>(p_value).c_str()));
+}
+
+/// Returns the decimal representation of p_value * 10^(-p_scale),
+/// where p_value is an integer
+std::string InsertDecimalPoint(const std::string &p_digits, int p_scale)
+{
+  bool negative = (p_digits[0] == '-');
+  std::string digits = (negative) ? p_digits.substr(1) : p_digits;
+  if (p_scale > 0) {
+    if ((int) digits.length() <= p_scale) {
+      digits = std::string(p_scale + 1 - digits.length(), '0') + digits;
+    }
+    digits.insert(digits.length() - p_scale, ".");
+  }
+  return (negative) ? ("-" + digits) : digits;
+}
+
+}  // end anonymous namespace
+
+//========================================================================
+//                          class Number
+//========================================================================
+
+Number &Number::operator=(const Number &p_number)
+{
+  if (this == &p_number)  return *this;
+  ClearCache();
+  m_kind = p_number.m_kind;
+  m_scale = p_number.m_scale;
+  m_num = p_number.m_num;
+  m_den = p_number.m_den;
+  m_double = p_number.m_double;
+  if (m_kind == NUMBER_BIG) {
+    m_rational = new Rational(*p_number.m_rational);
+  }
+  return *this;
+}
+
+//
+// The syntax accepted is that of lexical_cast<Rational>(): an optional
+// minus sign and a string of digits, followed by either a '/' and a
+// denominator, or by a fractional part and/or exponent.  The text is
+// scanned once, accumulating in machine words; anything which overflows,
+// or which is not in the common forms, is handed to lexical_cast<Rational>()
+// which will either build the bignum or throw the ValueException.
+//
+void Number::Parse(const char *p_begin, const char *p_end)
+{
+  const char *ch = p_begin, *end = p_end;
+  while (ch < end && isspace(*ch))  ch++;
+
+  bool negative = false;
+  if (ch < end && *ch == '-') {
+    negative = true;
+    ch++;
+  }
+
+  bool ok = true, isFraction = false;
+  long long mantissa = 0, denom = 1;
+  int digits = 0, fracDigits = 0, exponent = 0;
+
+  for (; ch < end && isdigit(*ch); ch++, digits++) {
+    ok = ok && AppendDigit(mantissa, *ch - '0');
+  }
+
+  if (ch < end && *ch == '/') {
+    isFraction = true;
+    denom = 0;
+    int denDigits = 0;
+    for (ch++; ch < end && isdigit(*ch); ch++, denDigits++) {
+      ok = ok && AppendDigit(denom, *ch - '0');
+    }
+    ok = ok && denDigits > 0 && denom != 0;
+  }
+  else {
+    if (ch < end && *ch == '.') {
+      for (ch++; ch < end && isdigit(*ch); ch++, fracDigits++, digits++) {
+	ok = ok && AppendDigit(mantissa, *ch - '0');
+      }
+    }
+    if (ch < end && (*ch == 'e' || *ch == 'E')) {
+      int expSign = 1;
+      if (++ch < end && *ch == '-') {
+	expSign = -1;
+	ch++;
+      }
+      for (; ch < end && isdigit(*ch); ch++) {
+	if (exponent > 9999) {
+	  ok = false;
+	}
+	else {
+	  exponent = 10 * exponent + (*ch - '0');
+	}
+      }
+      exponent *= expSign;
+    }
+  }
+
+  ok = ok && digits > 0 && ch == end;
+
+  if (isFraction || (fracDigits == 0 && exponent == 0)) {
+    m_scale = -1;
+  }
+  else {
+    m_scale = (fracDigits > exponent) ? (fracDigits - exponent) : 0;
+  }
+
+  if (ok && !isFraction) {
+    // Fold the decimal point and exponent into the numerator or
+    // denominator
+    long long power;
+    if (exponent > fracDigits) {
+      ok = (PowerOfTen(exponent - fracDigits, power) &&
+	    Multiply(mantissa, power, mantissa));
+    }
+    else {
+      ok = PowerOfTen(fracDigits - exponent, denom);
+    }
+  }
+
+  if (!ok) {
+    m_kind = NUMBER_BIG;
+    m_rational = new Rational(lexical_cast<Rational>(std::string(p_begin, p_end)));
+    m_num = 0;
+    m_den = 1;
+    m_double = (double) *m_rational;
+    return;
+  }
+
+  long long gcd = GreatestCommonDivisor(mantissa, denom);
+  m_kind = NUMBER_SMALL;
+  m_num = (negative) ? -(mantissa / gcd) : (mantissa / gcd);
+  m_den = denom / gcd;
+  ComputeDouble();
+}
+
+void Number::ComputeDouble(void)
+{
+  long long magnitude = (m_num < 0) ? -m_num : m_num;
+  if (magnitude >= c_exactDouble || m_den >= c_exactDouble) {
+    BuildRational();
+    m_double = (double) *m_rational;
+  }
+  else {
+    // This computes the quotient the same way as Rational::operator double
+    long long quot = magnitude / m_den;
+    long long rem = magnitude % m_den;
+    m_double = (double) quot;
+    if (rem != 0)  m_double += (double) rem / (double) m_den;
+    if (m_num < 0)  m_double = -m_double;
+  }
+}
+
+void Number::BuildRational(void) const
+{
+  m_rational = new Rational(ToInteger(m_num), ToInteger(m_den));
+}
+
+void Number::BuildText(void) const
+{
+  if (m_kind == NUMBER_SMALL) {
+    long long power, value;
+    if (m_scale < 0) {
+      if (m_den == 1) {
+	m_text = new std::string(lexical_cast<std::string>(m_num));
+      }
+      else {
+	m_text = new std::string(lexical_cast<std::string>(m_num) + "/" +
+				 lexical_cast<std::string>(m_den));
+      }
+      return;
+    }
+    else if (PowerOfTen(m_scale, power) &&
+	     Multiply((m_num < 0) ? -m_num : m_num, power / m_den, value)) {
+      if (m_num < 0)  value = -value;
+      m_text = new std::string(InsertDecimalPoint(lexical_cast<std::string>(value),
+						  m_scale));
+      return;
+    }
+  }
+
+  // General case, using arbitrary-precision arithmetic
+  const Rational &r = *this;
+  if (m_scale < 0) {
+    m_text = new std::string(lexical_cast<std::string>(r));
+  }
+  else {
+    Integer value = r.numerator() * Ipow(10, m_scale) / r.denominator();
+    m_text = new std::string(InsertDecimalPoint(lexical_cast<std::string>(value),
+						m_scale));
+  }
+}
+
+}  // end namespace Gambit
@@ -26,33 +26,102 @@
 namespace Gambit {
 
 /// This simple class stores a numerical datum.
+///
+/// The value is always held exactly.  Values whose numerator and
+/// denominator fit in a machine word are stored inline; only values
+/// which do not fit fall back to an arbitrary-precision Rational.
+/// The floating-point value is computed when the number is assigned,
+/// since that is the form most frequently accessed by the solvers.
+/// The Rational and text forms are only built the first time they
+/// are requested.
 class Number {
 private:
-  std::string m_text;
-  Rational m_rational;
+  enum Kind { NUMBER_SMALL = 0, NUMBER_BIG = 1 };
+
+  /// Which member holds the exact value
+  Kind m_kind;
+  /// Number of digits after the decimal point when written as text;
+  /// -1 if the value is written as a fraction
+  int m_scale;
+  /// The exact value, in lowest terms, when m_kind is NUMBER_SMALL
+  long long m_num, m_den;
+  /// The floating-point value
   double m_double;
+  /// The exact value when m_kind is NUMBER_BIG; otherwise, a cache
+  /// built on demand
+  mutable Rational *m_rational;
+  /// The text representation, built on demand
+  mutable std::string *m_text;
+
+  void Parse(const char *p_begin, const char *p_end);
+  void ComputeDouble(void);
+  void BuildRational(void) const;
+  void BuildText(void) const;
+  void ClearCache(void)
+  {
+    delete m_rational;  m_rational = 0;
+    delete m_text;  m_text = 0;
+  }
 
 public:
+  /// @name Lifecycle
+  //@{
   Number(void)
-    : m_text("0"), m_rational(0), m_double(0.0) { }
+    : m_kind(NUMBER_SMALL), m_scale(-1), m_num(0), m_den(1), m_double(0.0),
+      m_rational(0), m_text(0) { }
   Number(const std::string &p_text)
-    : m_text(p_text), m_rational(lexical_cast<Rational>(p_text)), 
-      m_double((double) m_rational)
+    : m_rational(0), m_text(0)
+  { Parse(p_text.c_str(), p_text.c_str() + p_text.length()); }
+  /// Constructs the number from the text in [p_begin, p_end), without
+  /// first copying it into a string
+  Number(const char *p_begin, const char *p_end)
+    : m_rational(0), m_text(0)
+  { Parse(p_begin, p_end); }
+  /// Constructs the number p_num / p_den, which must be in lowest
+  /// terms with a positive denominator, written with p_scale digits
+  /// after the decimal point (or as a fraction if p_scale is -1)
+  Number(long long p_num, long long p_den, int p_scale)
+    : m_kind(NUMBER_SMALL), m_scale(p_scale), m_num(p_num), m_den(p_den),
+      m_rational(0), m_text(0)
+  { ComputeDouble(); }
+  Number(const Number &p_number)
+    : m_kind(p_number.m_kind), m_scale(p_number.m_scale),
+      m_num(p_number.m_num), m_den(p_number.m_den),
+      m_double(p_number.m_double),
+      m_rational((p_number.m_kind == NUMBER_BIG) ?
+		 new Rational(*p_number.m_rational) : 0),
+      m_text(0)
   { }
-  
+  ~Number() { ClearCache(); }
+
+  Number &operator=(const Number &p_number);
   Number &operator=(const std::string &p_text)
   {
-    // We call lexical_cast<Rational>() first because it throws a ValueException
-    // if the conversion of the text fails
-    m_rational = lexical_cast<Rational>(p_text);
-    m_text = p_text;
-    m_double = (double) m_rational;
-    return *this; 
+    // Parse() throws a ValueException if the conversion of the text
+    // fails; in that case, the previous value is retained.
+    Number value(p_text);
+    return (*this = value);
   }
+  //@}
+
+  /// @name Data access
+  //@{
+  /// Returns true if the value is held in the inline representation
+  bool IsSmall(void) const { return (m_kind == NUMBER_SMALL); }
+  /// Returns the numerator of the inline representation
+  long long GetNumerator(void) const { return m_num; }
+  /// Returns the denominator of the inline representation
+  long long GetDenominator(void) const { return m_den; }
+  /// Returns the number of digits after the decimal point in the text
+  /// form, or -1 if the value is written as a fraction
+  int GetScale(void) const { return m_scale; }
 
   operator const double &(void) const { return m_double; }
-  operator const Rational &(void) const { return m_rational; }
-  operator const std::string &(void) const { return m_text; }
+  operator const Rational &(void) const
+  { if (!m_rational) BuildRational();  return *m_rational; }
+  operator const std::string &(void) const
+  { if (!m_text) BuildText();  return *m_text; }
+  //@}
 };
 
 }
@@ -67,68 +67,115 @@ void Rational::normalize()
     }
 }
 
+//
+// The arithmetic operations below follow Knuth, TAOCP vol. 2, 4.5.1:
+// since the operands are in lowest terms, dividing out the gcds of
+// the cross terms first keeps intermediate values small and gives a
+// result which is already in lowest terms, without a gcd of the
+// (larger) full products.  The results are computed into temporaries
+// so that r may be the same object as x or y.
+//
+
 void      add(const Rational& x, const Rational& y, Rational& r)
 {
-  if (&r != &x && &r != &y)
+  Integer d1 = gcd(x.den, y.den);
+  if (d1 == 1)
     {
-      mul(x.num, y.den, r.num);
-      mul(x.den, y.num, r.den);
-      add(r.num, r.den, r.num);
+      Integer t = x.num * y.den + y.num * x.den;
+      if (sign(t) == 0)
+	{
+	  r.num = 0;
+	  r.den = 1;
+	  return;
+	}
       mul(x.den, y.den, r.den);
+      r.num = t;
     }
   else
     {
-      Integer tmp;
-      mul(x.den, y.num, tmp);
-      mul(x.num, y.den, r.num);
-      add(r.num, tmp, r.num);
-      mul(x.den, y.den, r.den);
+      Integer xd = x.den / d1;
+      Integer t = x.num * (y.den / d1) + y.num * xd;
+      if (sign(t) == 0)
+	{
+	  r.num = 0;
+	  r.den = 1;
+	  return;
+	}
+      Integer d2 = gcd(t, d1);
+      mul(xd, y.den / d2, r.den);
+      div(t, d2, r.num);
     }
-  r.normalize();
 }
 
 void      sub(const Rational& x, const Rational& y, Rational& r)
 {
-  if (&r != &x && &r != &y)
+  Integer d1 = gcd(x.den, y.den);
+  if (d1 == 1)
     {
-      mul(x.num, y.den, r.num);
-      mul(x.den, y.num, r.den);
-      sub(r.num, r.den, r.num);
+      Integer t = x.num * y.den - y.num * x.den;
+      if (sign(t) == 0)
+	{
+	  r.num = 0;
+	  r.den = 1;
+	  return;
+	}
       mul(x.den, y.den, r.den);
+      r.num = t;
     }
   else
     {
-      Integer tmp;
-      mul(x.den, y.num, tmp);
-      mul(x.num, y.den, r.num);
-      sub(r.num, tmp, r.num);
-      mul(x.den, y.den, r.den);
+      Integer xd = x.den / d1;
+      Integer t = x.num * (y.den / d1) - y.num * xd;
+      if (sign(t) == 0)
+	{
+	  r.num = 0;
+	  r.den = 1;
+	  return;
+	}
+      Integer d2 = gcd(t, d1);
+      mul(xd, y.den / d2, r.den);
+      div(t, d2, r.num);
     }
-  r.normalize();
 }
 
 void      mul(const Rational& x, const Rational& y, Rational& r)
 {
-  mul(x.num, y.num, r.num);
-  mul(x.den, y.den, r.den);
-  r.normalize();
+  if (sign(x.num) == 0 || sign(y.num) == 0)
+    {
+      r.num = 0;
+      r.den = 1;
+      return;
+    }
+  Integer d1 = gcd(x.num, y.den);
+  Integer d2 = gcd(x.den, y.num);
+  Integer n = (x.num / d1) * (y.num / d2);
+  mul(x.den / d2, y.den / d1, r.den);
+  r.num = n;
 }
 
 void      div(const Rational& x, const Rational& y, Rational& r)
 {
-  if (&r != &x && &r != &y)
+  if (sign(y.num) == 0)
     {
-      mul(x.num, y.den, r.num);
-      mul(x.den, y.num, r.den);
+      r.error("Zero denominator.");
+      return;
     }
-  else
+  if (sign(x.num) == 0)
     {
-      Integer tmp;
-      mul(x.num, y.den, tmp);
-      mul(y.num, x.den, r.den);
-      r.num = tmp;
+      r.num = 0;
+      r.den = 1;
+      return;
+    }
+  Integer d1 = gcd(x.num, y.num);
+  Integer d2 = gcd(x.den, y.den);
+  Integer n = (x.num / d1) * (y.den / d2);
+  mul(x.den / d2, y.num / d1, r.den);
+  r.num = n;
+  if (sign(r.den) < 0)
+    {
+      r.den.negate();
+      r.num.negate();
     }
-  r.normalize();
 }
 
 
@@ -0,0 +1,274 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/snapshot.cc
+// Reading and writing binary game snapshots
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <climits>
+#include <cstring>
+#include <iostream>
+
+#include "libgambit.h"
+#include "snapshot.h"
+#include "gametable.h"
+#include "gametree.h"
+#include "gameagg.h"
+
+namespace Gambit {
+
+namespace {
+
+/// The signature at the start of every snapshot.  The leading byte is
+/// not valid text, so a snapshot is never mistaken for a text savefile.
+const char c_signature[8] = { '\211', 'G', 'B', 'T', 'S', 'N', 'P', '\n' };
+
+/// The version of the layout written by this code
+const int c_version = 1;
+
+/// Tags distinguishing the two encodings of numbers
+const char c_numberSmall = 0;
+const char c_numberText = 1;
+
+}  // end anonymous namespace
+
+//========================================================================
+//                         class SnapshotWriter
+//========================================================================
+
+SnapshotWriter::SnapshotWriter(std::ostream &p_file, GameSnapshotKind p_kind)
+  : m_file(p_file)
+{
+  m_buffer.append(c_signature, sizeof(c_signature));
+  WriteInt(c_version);
+  WriteInt(p_kind);
+}
+
+void SnapshotWriter::WriteInt(int p_value)
+{
+  unsigned int value = (unsigned int) p_value;
+  for (int i = 0; i < 4; i++, value >>= 8) {
+    m_buffer += (char) (value & 0xff);
+  }
+  if (m_buffer.length() >= 65536)  Flush();
+}
+
+void SnapshotWriter::WriteLong(long long p_value)
+{
+  unsigned long long value = (unsigned long long) p_value;
+  for (int i = 0; i < 8; i++, value >>= 8) {
+    m_buffer += (char) (value & 0xff);
+  }
+  if (m_buffer.length() >= 65536)  Flush();
+}
+
+void SnapshotWriter::WriteString(const std::string &p_value)
+{
+  WriteInt(p_value.length());
+  m_buffer += p_value;
+  if (m_buffer.length() >= 65536)  Flush();
+}
+
+void SnapshotWriter::WriteVarLong(unsigned long long p_value)
+{
+  for (; p_value >= 0x80; p_value >>= 7) {
+    m_buffer += (char) ((p_value & 0x7f) | 0x80);
+  }
+  m_buffer += (char) p_value;
+}
+
+//
+// Small numbers are written with the numerator zigzag-encoded (so that
+// small negative values are also short), followed by the denominator
+// and one more than the scale, each as a variable-length integer.
+// Typical payoffs then take only a few bytes.
+//
+void SnapshotWriter::WriteNumber(const Number &p_value)
+{
+  if (p_value.IsSmall()) {
+    long long num = p_value.GetNumerator();
+    m_buffer += c_numberSmall;
+    WriteVarLong(((unsigned long long) num << 1) ^ (unsigned long long) (num >> 63));
+    WriteVarLong(p_value.GetDenominator());
+    WriteVarLong(p_value.GetScale() + 1);
+    if (m_buffer.length() >= 65536)  Flush();
+  }
+  else {
+    m_buffer += c_numberText;
+    WriteString((const std::string &) p_value);
+  }
+}
+
+void SnapshotWriter::Flush(void)
+{
+  m_file.write(m_buffer.data(), m_buffer.length());
+  m_buffer.clear();
+}
+
+//========================================================================
+//                         class SnapshotReader
+//========================================================================
+
+SnapshotReader::SnapshotReader(const char *p_begin, const char *p_end)
+  : m_current(p_begin), m_end(p_end)
+{
+  if (!IsSnapshot(p_begin, p_end)) {
+    throw InvalidFileException("Not a game snapshot");
+  }
+  m_current += sizeof(c_signature);
+
+  if (ReadInt() != c_version) {
+    throw InvalidFileException("Unsupported game snapshot version");
+  }
+  int kind = ReadInt();
+  if (kind < SNAPSHOT_TABLE || kind > SNAPSHOT_AGG) {
+    throw Error();
+  }
+  m_kind = (GameSnapshotKind) kind;
+}
+
+void SnapshotReader::Require(long long p_bytes) const
+{
+  if (p_bytes < 0 || p_bytes > m_end - m_current) {
+    throw Error();
+  }
+}
+
+int SnapshotReader::ReadInt(void)
+{
+  Require(4);
+  unsigned int value = 0;
+  for (int i = 3; i >= 0; i--) {
+    value = (value << 8) | (unsigned char) m_current[i];
+  }
+  m_current += 4;
+  return (int) value;
+}
+
+long long SnapshotReader::ReadLong(void)
+{
+  Require(8);
+  unsigned long long value = 0;
+  for (int i = 7; i >= 0; i--) {
+    value = (value << 8) | (unsigned char) m_current[i];
+  }
+  m_current += 8;
+  return (long long) value;
+}
+
+unsigned long long SnapshotReader::ReadVarLong(void)
+{
+  unsigned long long value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    Require(1);
+    unsigned char byte = (unsigned char) *m_current++;
+    value |= (unsigned long long) (byte & 0x7f) << shift;
+    if (!(byte & 0x80))  return value;
+  }
+  throw Error();
+}
+
+std::string SnapshotReader::ReadString(void)
+{
+  int length = ReadCount(1);
+  std::string value(m_current, length);
+  m_current += length;
+  return value;
+}
+
+Number SnapshotReader::ReadNumber(void)
+{
+  Require(1);
+  char tag = *m_current++;
+  if (tag == c_numberSmall) {
+    unsigned long long zigzag = ReadVarLong();
+    long long num = (long long) (zigzag >> 1) ^ -(long long) (zigzag & 1);
+    long long den = (long long) ReadVarLong();
+    unsigned long long scale = ReadVarLong();
+    if (num == LLONG_MIN || den <= 0 || scale > INT_MAX) {
+      throw Error();
+    }
+    return Number(num, den, (int) scale - 1);
+  }
+  else if (tag == c_numberText) {
+    return Number(ReadString());
+  }
+  else {
+    throw Error();
+  }
+}
+
+int SnapshotReader::ReadCount(int p_itemSize)
+{
+  int count = ReadInt();
+  if (count < 0) {
+    throw Error();
+  }
+  Require((long long) count * p_itemSize);
+  return count;
+}
+
+int SnapshotReader::ReadIndex(int p_min, int p_max)
+{
+  int index = ReadInt();
+  if (index < p_min || index > p_max) {
+    throw Error();
+  }
+  return index;
+}
+
+InvalidFileException SnapshotReader::Error(void) const
+{
+  return InvalidFileException("Game snapshot is truncated or corrupt");
+}
+
+//========================================================================
+//                  Global functions for reading snapshots
+//========================================================================
+
+bool IsSnapshot(const char *p_begin, const char *p_end)
+{
+  return (p_end - p_begin >= (int) sizeof(c_signature) &&
+	  memcmp(p_begin, c_signature, sizeof(c_signature)) == 0);
+}
+
+Game ReadSnapshot(const char *p_begin, const char *p_end)
+{
+  SnapshotReader reader(p_begin, p_end);
+
+  try {
+    switch (reader.GetKind()) {
+    case SNAPSHOT_TABLE:
+      return GameTableRep::ReadSnapshot(reader);
+    case SNAPSHOT_TREE:
+      return GameTreeRep::ReadSnapshot(reader);
+    default:
+      return GameAggRep::ReadSnapshot(reader);
+    }
+  }
+  catch (InvalidFileException &) {
+    throw;
+  }
+  catch (std::exception &e) {
+    // For example, an out-of-range index or an invalid number
+    throw InvalidFileException(std::string("Invalid game snapshot: ") +
+			       e.what());
+  }
+}
+
+}  // end namespace Gambit
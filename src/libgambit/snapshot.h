@@ -0,0 +1,110 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/snapshot.h
+// Reading and writing binary game snapshots
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_SNAPSHOT_H
+#define LIBGAMBIT_SNAPSHOT_H
+
+#include "game.h"
+
+namespace Gambit {
+
+//
+// A snapshot is a binary image of a game, intended for passing games
+// between programs and for loading large games quickly.  It begins with
+// an eight-byte signature, a format version, and the kind of game; the
+// layout of the remainder is documented with the WriteSnapshotFile()
+// member of each game representation.
+//
+// All integers are stored little-endian in fixed widths, and are read
+// a byte at a time, so a snapshot can be parsed in place from any
+// buffer, including a memory-mapped file.  Payoffs and probabilities
+// are stored exactly, as their numerator and denominator when these
+// fit in a machine word, and as text otherwise.
+//
+
+/// The kinds of game which can be stored in a snapshot
+typedef enum {
+  SNAPSHOT_TABLE = 1, SNAPSHOT_TREE = 2, SNAPSHOT_AGG = 3
+} GameSnapshotKind;
+
+/// Writes the elements of a snapshot to a stream
+class SnapshotWriter {
+private:
+  std::ostream &m_file;
+  std::string m_buffer;
+
+  void WriteVarLong(unsigned long long p_value);
+
+public:
+  /// Writes the snapshot header for a game of the given kind
+  SnapshotWriter(std::ostream &p_file, GameSnapshotKind p_kind);
+  /// Flushes any buffered output
+  ~SnapshotWriter() { Flush(); }
+
+  void WriteInt(int p_value);
+  void WriteLong(long long p_value);
+  void WriteString(const std::string &p_value);
+  void WriteNumber(const Number &p_value);
+
+  /// Writes the buffered output to the stream
+  void Flush(void);
+};
+
+/// Reads the elements of a snapshot from a buffer
+class SnapshotReader {
+private:
+  const char *m_current, *m_end;
+  GameSnapshotKind m_kind;
+
+  unsigned long long ReadVarLong(void);
+
+public:
+  /// Reads the snapshot header; the buffer is not copied
+  SnapshotReader(const char *p_begin, const char *p_end);
+
+  GameSnapshotKind GetKind(void) const { return m_kind; }
+
+  int ReadInt(void);
+  long long ReadLong(void);
+  std::string ReadString(void);
+  Number ReadNumber(void);
+  /// Reads a count of items, each occupying at least p_itemSize bytes,
+  /// and checks it against the size of the remaining data
+  int ReadCount(int p_itemSize);
+  /// Reads an integer, and checks it lies in [p_min, p_max]
+  int ReadIndex(int p_min, int p_max);
+
+  /// Checks that at least p_bytes bytes of data remain
+  void Require(long long p_bytes) const;
+
+  /// Returns an exception for a snapshot which is truncated or corrupt
+  InvalidFileException Error(void) const;
+};
+
+/// Returns true if the data in [p_begin, p_end) is a game snapshot
+bool IsSnapshot(const char *p_begin, const char *p_end);
+/// Reads the game snapshot in [p_begin, p_end)
+Game ReadSnapshot(const char *p_begin, const char *p_end);
+
+}  // end namespace Gambit
+
+#endif  // LIBGAMBIT_SNAPSHOT_H
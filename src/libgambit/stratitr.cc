@@ -20,7 +20,10 @@
 // Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
 //
 
+#include <algorithm>
+
 #include "libgambit.h"
+#include "gametable.h"
 
 namespace Gambit {
 
@@ -123,4 +126,124 @@ void StrategyIterator::operator++(void)
   }
 }
 
+//===========================================================================
+//                       class ContingencyIterator
+//===========================================================================
+
+//---------------------------------------------------------------------------
+//                               Lifecycle
+//---------------------------------------------------------------------------
+
+ContingencyIterator::ContingencyIterator(const StrategySupport &p_support)
+  : m_support(p_support), m_numPlayers(p_support.GetGame()->NumPlayers()),
+    m_results(0), m_offsets(m_numPlayers), m_current(m_numPlayers),
+    m_index(1L), m_position(0L), m_end(NumContingencies(p_support))
+{
+  First(0L);
+}
+
+ContingencyIterator::ContingencyIterator(const StrategySupport &p_support,
+					 int p_part, int p_numParts)
+  : m_support(p_support), m_numPlayers(p_support.GetGame()->NumPlayers()),
+    m_results(0), m_offsets(m_numPlayers), m_current(m_numPlayers),
+    m_index(1L), m_position(0L), m_end(0L)
+{
+  if (p_numParts < 1 || p_part < 1 || p_part > p_numParts) {
+    throw IndexException();
+  }
+
+  // The first (total % numParts) parts each get one extra contingency
+  long total = NumContingencies(p_support);
+  long size = total / p_numParts, extra = total % p_numParts;
+  long begin = size * (p_part - 1) + std::min((long) (p_part - 1), extra);
+  m_end = begin + size + ((p_part <= extra) ? 1 : 0);
+  First(begin);
+}
+
+long ContingencyIterator::NumContingencies(const StrategySupport &p_support)
+{
+  long count = 1L;
+  for (int pl = 1; pl <= p_support.GetGame()->NumPlayers(); pl++) {
+    count *= p_support.NumStrategies(pl);
+  }
+  return count;
+}
+
+//---------------------------------------------------------------------------
+//                                Iteration
+//---------------------------------------------------------------------------
+
+void ContingencyIterator::First(long p_position)
+{
+  GameTableRep *table = dynamic_cast<GameTableRep *>(&*m_support.GetGame());
+  if (table) {
+    m_results = &table->m_results;
+    for (int pl = 1; pl <= m_numPlayers; pl++) {
+      m_offsets[pl] = Array<long>(m_support.NumStrategies(pl));
+      for (int st = 1; st <= m_offsets[pl].Length(); st++) {
+	m_offsets[pl][st] = m_support.GetStrategy(pl, st)->m_offset;
+      }
+    }
+  }
+  else {
+    m_profile = m_support.GetGame()->NewPureStrategyProfile();
+  }
+
+  // The position is written in mixed radix, with the first player's
+  // strategy as the lowest digit
+  m_position = p_position;
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    int numStrats = m_support.NumStrategies(pl);
+    if (numStrats == 0) {
+      m_current[pl] = 1;
+      continue;
+    }
+    int st = 1 + (int) (p_position % numStrats);
+    p_position /= numStrats;
+    if (m_results) {
+      m_index += m_offsets[pl][st];
+    }
+    else {
+      m_profile->SetStrategy(m_support.GetStrategy(pl, st));
+    }
+    m_current[pl] = st;
+  }
+}
+
+void ContingencyIterator::SetStrategy(int pl, int st)
+{
+  if (m_results) {
+    m_index += m_offsets[pl][st] - m_offsets[pl][m_current[pl]];
+  }
+  else {
+    m_profile->SetStrategy(m_support.GetStrategy(pl, st));
+  }
+  m_current[pl] = st;
+}
+
+void ContingencyIterator::operator++(void)
+{
+  if (++m_position >= m_end)  return;
+
+  // Since the end has not been reached, some player's strategy
+  // can be advanced without wrapping around
+  for (int pl = 1; ; pl++) {
+    if (m_current[pl] < m_support.NumStrategies(pl)) {
+      SetStrategy(pl, m_current[pl] + 1);
+      return;
+    }
+    SetStrategy(pl, 1);
+  }
+}
+
+//---------------------------------------------------------------------------
+//                               Data access
+//---------------------------------------------------------------------------
+
+long ContingencyIterator::GetIndex(void) const
+{
+  if (!m_results)  throw UndefinedException();
+  return m_index;
+}
+
 } // end namespace Gambit
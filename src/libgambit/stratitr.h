@@ -75,6 +75,91 @@ public:
   //@}
 };
 
+/// This class also iterates through the contingencies in a strategic
+/// game, in the same order as StrategyIterator, but is intended for
+/// loops which read payoffs at every contingency.  On table games it
+/// tracks the position of the contingency in the table directly, so
+/// advancing and reading payoffs involve neither a PureStrategyProfile
+/// nor any virtual calls.  On other games, it falls back to a profile.
+///
+/// The contingencies may also be divided into a number of consecutive
+/// parts, each visited by its own iterator; the iterators share no
+/// state, so the parts may be traversed in parallel.
+class ContingencyIterator {
+private:
+  StrategySupport m_support;
+  int m_numPlayers;
+  const Array<GameOutcomeRep *> *m_results;
+  Array<Array<long> > m_offsets;
+  Array<int> m_current;
+  long m_index, m_position, m_end;
+  PureStrategyProfile m_profile;
+
+  /// Start the iteration at the contingency with ordinal p_position
+  void First(long p_position);
+  /// Set the strategy of player pl to the st'th in the support
+  void SetStrategy(int pl, int st);
+
+public:
+  /// @name Lifecycle
+  //@{
+  /// Construct a new iterator over all contingencies on the support
+  ContingencyIterator(const StrategySupport &);
+  /// Construct a new iterator over the p_part'th of p_numParts
+  /// consecutive parts of the contingencies on the support
+  ContingencyIterator(const StrategySupport &, int p_part, int p_numParts);
+  //@}
+
+  /// @name Iteration
+  //@{
+  /// Advance to the next contingency (prefix version)
+  void operator++(void);
+  /// Advance to the next contingency (postfix version)
+  void operator++(int) { ++(*this); }
+  /// Has iterator gone past the end?
+  bool AtEnd(void) const { return m_position >= m_end; }
+
+  /// Returns the number of contingencies on the support
+  static long NumContingencies(const StrategySupport &);
+  //@}
+
+  /// @name Data access
+  //@{
+  /// Returns the ordinal of the current contingency, counting from zero
+  /// in the order of iteration over the whole support
+  long GetPosition(void) const { return m_position; }
+  /// Returns the index of the current contingency in the game's table,
+  /// as PureStrategyProfileRep::GetIndex() would (table games only)
+  long GetIndex(void) const;
+  /// Returns the index within the support of player pl's strategy
+  int GetStrategyIndex(int pl) const { return m_current[pl]; }
+  /// Returns the strategy played by player pl
+  GameStrategy GetStrategy(int pl) const
+  { return m_support.GetStrategy(pl, m_current[pl]); }
+
+  /// Returns the payoff to player pl at the current contingency
+  template <class T> T GetPayoff(int pl) const
+  {
+    if (m_results) {
+      GameOutcomeRep *outcome = (*m_results)[m_index];
+      return (outcome) ? outcome->GetPayoff<T>(pl) : T(0);
+    }
+    return (T) m_profile->GetPayoff(pl);
+  }
+  /// Returns the payoff to player pl, were the player to switch to
+  /// the st'th strategy in the support
+  template <class T> T GetStrategyValue(int pl, int st) const
+  {
+    if (m_results) {
+      GameOutcomeRep *outcome = 
+	(*m_results)[m_index - m_offsets[pl][m_current[pl]] + m_offsets[pl][st]];
+      return (outcome) ? outcome->GetPayoff<T>(pl) : T(0);
+    }
+    return (T) m_profile->GetStrategyValue(m_support.GetStrategy(pl, st));
+  }
+  //@}
+};
+
 } // end namespace Gambit
 
 #endif // LIBGAMBIT_STRATITR_H
@@ -22,6 +22,7 @@
 
 #include "libgambit.h"
 #include "subgame.h"
+#include "workpool.h"
 
 #include <cstdlib>
 
@@ -32,18 +33,6 @@ namespace Gambit {
 
 namespace {
 
-///
-/// Returns a copy of the game 'p_efg', including only the subtree rooted
-/// at 'p_node'.
-///
-Game CopyGame(const Game &p_efg, const GameNode &p_node)
-{
-  std::ostringstream os;
-  p_efg->WriteEfgFile(os, p_node);
-  std::istringstream is(os.str());
-  return ReadGame(is);
-}
-
 ///
 /// Returns a list of the root nodes of all the immediate proper subgames
 /// in the subtree rooted at 'p_node'.
@@ -59,185 +48,220 @@ void ChildSubgames(const GameNode &p_node, List<GameNode> &p_list)
   }
 }
 
+///
+/// Returns the sequence of child indices leading from the root of the
+/// game to 'p_node'.
+///
+Array<int> PathTo(GameNode p_node)
+{
+  List<int> reversed;
+  for (; p_node->GetParent(); p_node = p_node->GetParent()) {
+    reversed.Append(p_node->GetPriorAction()->GetNumber());
+  }
+  Array<int> path(reversed.Length());
+  for (int i = 1; i <= path.Length(); i++) {
+    path[i] = reversed[reversed.Length() - i + 1];
+  }
+  return path;
+}
+
+///
+/// Returns the node reached from the root of 'p_efg' along 'p_path'.
+///
+GameNode FollowPath(const Game &p_efg, const Array<int> &p_path)
+{
+  GameNode node = p_efg->GetRoot();
+  for (int i = 1; i <= p_path.Length(); i++) {
+    node = node->GetChild(p_path[i]);
+  }
+  return node;
+}
+
 } // end nested anonymous namespace
 
 
 //
 // Some general notes on the strategy for solving by subgames:
 //
-// * We work with a *copy* of the original game, which is destroyed
-//   as we go.
-// * Before solving, information set labels on the copy game are
-//   set to unique IDs.  These are used to match up information
-//   sets in the subgames (which are themselves copies) to the
-//   original game.
+// * Each subgame is solved in a game of its own: the subtree is copied
+//   out of the game containing it, and then cut off there, leaving its
+//   root as a terminal node.  Games of sibling subgames share nothing,
+//   so the siblings are solved concurrently, as tasks on a WorkPool.
+// * Before solving, information set labels on the copy of the original
+//   game are set to unique IDs.  These are used to match up information
+//   sets in the subgames to the original game.
 // * We only carry around DVectors instead of full MixedBehavProfiles,
 //   because MixedBehavProfiles allocate space several times the
 //   size of the tree to carry around useful quantities.  These
 //   quantities are irrelevant for this calculation, so we only
 //   store the probabilities, and convert to MixedBehavProfiles
 //   at the end of the computation
+// * Once the child subgames are solved, the subgame is solved for
+//   each combination of the solutions of its children in turn, with the
+//   payoffs at the roots of the children set to the values of those
+//   solutions.  The combinations are enumerated one at a time, rather
+//   than all being built up front.
 //
 
 template <class T, class SolverType>
-void SolveSubgames(const BehavSupport &p_support,
-		   const DVector<T> &p_templateSolution,
-		   SolverType p_solver,
-		   GameNode n,
-		   List<DVector<T> > &solns,
-		   List<GameOutcome> &values)
+class SubgameTask : public WorkTask {
+private:
+  WorkPool &m_pool;
+  Game m_efg;
+  const DVector<T> &m_templateSolution;
+  SolverType m_solver;
+  Array<SubgameTask<T, SolverType> *> m_children;
+
+public:
+  /// The solutions of the subgame, with entries for the whole game
+  List<DVector<T> > m_solutions;
+  /// The payoffs to the players of each solution
+  List<Vector<T> > m_values;
+
+  /// Prepares to solve the game 'p_efg', which is given over to the task
+  SubgameTask(WorkPool &p_pool, const Game &p_efg,
+	      const DVector<T> &p_templateSolution, SolverType p_solver)
+    : m_pool(p_pool), m_efg(p_efg), m_templateSolution(p_templateSolution),
+      m_solver(p_solver) { }
+  virtual ~SubgameTask();
+
+  void Run(void);
+};
+
+template <class T, class SolverType>
+SubgameTask<T, SolverType>::~SubgameTask()
 {
-  Game efg = p_support.GetGame();
-  
-  List<DVector<T> > thissolns;
-  thissolns.Append(p_templateSolution);
-  ((Vector<T> &) thissolns[1]).operator=(T(0));
-  
+  for (int i = 1; i <= m_children.Length(); i++) {
+    delete m_children[i];
+  }
+}
+
+template <class T, class SolverType>
+void SubgameTask<T, SolverType>::Run(void)
+{
+  GameNode root = m_efg->GetRoot();
+
   List<GameNode> subroots;
-  for (int i = 1; i <= n->NumChildren(); i++) {
-    ChildSubgames(n->GetChild(i), subroots);
+  for (int i = 1; i <= root->NumChildren(); i++) {
+    ChildSubgames(root->GetChild(i), subroots);
   }
-  
-  List<Array<GameOutcome> > subrootvalues;
-  subrootvalues.Append(Array<GameOutcome>(subroots.Length()));
-  
-  for (int i = 1; i <= subroots.Length(); i++)  {
-    //printf("Looking at subgame %d of %d\n", i, subroots.Length());
-    List<DVector<T> > subsolns;
-    List<GameOutcome> subvalues;
-    
-    SolveSubgames(p_support, p_templateSolution, p_solver,
-		  subroots[i], subsolns, subvalues);
-    
-    if (subsolns.Length() == 0)  {
-      solns = List<DVector<T> >();
+
+  WorkGroup group(m_pool);
+  Array<Array<int> > paths(subroots.Length());
+  m_children = Array<SubgameTask<T, SolverType> *>(subroots.Length());
+  for (int i = 1; i <= m_children.Length(); i++) {
+    m_children[i] = 0;
+  }
+  for (int i = 1; i <= subroots.Length(); i++) {
+    m_children[i] = new SubgameTask<T, SolverType>(m_pool, 
+						   m_efg->Copy(subroots[i]),
+						   m_templateSolution,
+						   m_solver);
+    group.Submit(m_children[i]);
+    paths[i] = PathTo(subroots[i]);
+    subroots[i]->DeleteTree();
+  }
+
+  // The subgame, less its children, is copied afresh so that it carries
+  // only the outcomes still in use
+  Game subgame = m_efg->Copy(root);
+  subroots = List<GameNode>();
+  root = 0;
+  m_efg = 0;
+
+  group.Wait();
+  for (int i = 1; i <= m_children.Length(); i++) {
+    if (m_children[i]->m_solutions.Length() == 0) {
+      //printf("No solutions found for subgame %d\n", i);
       return;
     }
+  }
 
-    //printf("Found %d subsolutions for subgame %d of %d\n", 
-    //subsolns.Length(), i, subroots.Length());
-    
-    List<DVector<T> > newsolns;
-    List<Array<GameOutcome> > newsubrootvalues;
-    
-    //printf("Merging with %d existing solutions\n", thissolns.Length());
-    for (int soln = 1; soln <= thissolns.Length(); soln++) {
-      for (int subsoln = 1; subsoln <= subsolns.Length(); subsoln++) {
-	//printf("Merging existing %d with new %d\n", soln, subsoln);
-	DVector<T> bp(thissolns[soln]);
-	DVector<T> tmp(subsolns[subsoln]);
-	for (int j = 1; j <= bp.Length(); j++) {
-	  bp[j] += tmp[j];
-	}
-	newsolns.Append(bp);
-	
-	newsubrootvalues.Append(subrootvalues[soln]);
-	newsubrootvalues[newsubrootvalues.Length()][i] = subvalues[subsoln];
-      }
-    }
-    
-    thissolns = newsolns;
-    subrootvalues = newsubrootvalues;
-    //printf("Finished solving subgame %d\n", i);
+  // this prevents double-counting of outcomes at roots of subgames
+  // by convention, we will just put the payoffs in the parent subgame
+  GameOutcome outcome = subgame->GetRoot()->GetOutcome();
+  subgame->GetRoot()->SetOutcome(0);
+
+  Array<GameOutcome> subrootOutcomes(m_children.Length());
+  for (int i = 1; i <= m_children.Length(); i++) {
+    subrootOutcomes[i] = subgame->NewOutcome();
+    FollowPath(subgame, paths[i])->SetOutcome(subrootOutcomes[i]);
   }
-  
-  for (int soln = 1; soln <= thissolns.Length(); soln++)   {
-    //printf("Analyzing scenario %d of %d\n", soln, thissolns.Length());
-    for (int i = 1; i <= subroots.Length(); i++) {
-      subroots[i]->SetOutcome(subrootvalues[soln][i]);
-    }
-    
-    Game subgame = CopyGame(efg, n);
-    // this prevents double-counting of outcomes at roots of subgames
-    // by convention, we will just put the payoffs in the parent subgame
-    subgame->GetRoot()->SetOutcome(0);
-
-    BehavSupport subsupport(subgame);
-    // Here, we build the support for the subgame
-    /*
-    for (int pl = 1; pl <= subgame->NumPlayers(); pl++)  {
-      GamePlayer subplayer = subgame->GetPlayer(pl);
-      GamePlayer player = p_support.GetGame()->GetPlayer(pl);
-
-      for (int iset = 1; iset <= subplayer->NumInfosets(); iset++) {
-	GameInfoset subinfoset = subplayer->GetInfoset(iset);
-
-	for (int j = 1; j <= player->NumInfosets(); j++) {
-	  GameInfoset infoset = player->GetInfoset(j);
-	  if (subinfoset->GetLabel() == infoset->GetLabel()) {
-	    for (int act = 1; act <= infoset->NumActions(); act++)  {
-	      if (!p_support.Contains(infoset->GetAction(act))) {
-		subsupport.RemoveAction(subinfoset->GetAction(act));
-	      }
-	    }
-	    break;
-	  }
-	}
+
+  BehavSupport subsupport(subgame);
+
+  // The index of the solution of each child in the current combination;
+  // the last child varies fastest
+  Array<int> choice(m_children.Length());
+  for (int i = 1; i <= choice.Length(); i++) {
+    choice[i] = 1;
+  }
+
+  while (true) {
+    DVector<T> bp(m_templateSolution);
+    ((Vector<T> &) bp).operator=(T(0));
+    for (int i = 1; i <= m_children.Length(); i++) {
+      const DVector<T> &tmp = m_children[i]->m_solutions[choice[i]];
+      for (int j = 1; j <= bp.Length(); j++) {
+	bp[j] += tmp[j];
+      }
+
+      const Vector<T> &value = m_children[i]->m_values[choice[i]];
+      for (int pl = 1; pl <= subgame->NumPlayers(); pl++) {
+	subrootOutcomes[i]->SetPayoff(pl, lexical_cast<std::string>(value[pl]));
       }
     }
-    */
 
-    List<MixedBehavProfile<T> > sol = (*p_solver)(subsupport);
+    List<MixedBehavProfile<T> > sol = (*m_solver)(subsupport);
     
     if (sol.Length() == 0)  {
-      solns = List<DVector<T> >();
+      m_solutions = List<DVector<T> >();
+      m_values = List<Vector<T> >();
       //printf("No solutions found\n");
       return;
     }
     
     // Put behavior profile in "total" solution here...
     for (int solno = 1; solno <= sol.Length(); solno++)  {
-      solns.Append(thissolns[soln]);
+      m_solutions.Append(bp);
+      DVector<T> &solution = m_solutions[m_solutions.Length()];
       
       for (int pl = 1; pl <= subgame->NumPlayers(); pl++)  {
 	GamePlayer subplayer = subgame->GetPlayer(pl);
-	GamePlayer player = p_support.GetGame()->GetPlayer(pl);
 
 	for (int iset = 1; iset <= subplayer->NumInfosets(); iset++) {
-	  GameInfoset subinfoset = subplayer->GetInfoset(iset);
-
-	  for (int j = 1; j <= player->NumInfosets(); j++) {
-	    if (subinfoset->GetLabel() == player->GetInfoset(j)->GetLabel()) {
-	      int id = atoi(subinfoset->GetLabel().c_str());
-	      for (int act = 1; act <= subsupport.NumActions(pl, iset); act++) {
-		int actno = subsupport.GetAction(pl, iset, act)->GetNumber();
-		solns[solns.Length()](pl, id, actno) = sol[solno](pl, iset, act);	  
-	      }
-	      break;
-	    }
+	  int id = atoi(subplayer->GetInfoset(iset)->GetLabel().c_str());
+	  for (int act = 1; act <= subsupport.NumActions(pl, iset); act++) {
+	    int actno = subsupport.GetAction(pl, iset, act)->GetNumber();
+	    solution(pl, id, actno) = sol[solno](pl, iset, act);
 	  }
 	}
       }
       
       Vector<T> subval(subgame->NumPlayers());
-      GameOutcome outcome = n->GetOutcome();
       for (int pl = 1; pl <= subgame->NumPlayers(); pl++)  {
 	subval[pl] = sol[solno].GetPayoff(pl);
 	if (outcome) {
 	  subval[pl] += outcome->GetPayoff<T>(pl);
         }
       }
+      m_values.Append(subval);
+    }
 
-      GameOutcome ov = efg->NewOutcome();
-      for (int pl = 1; pl <= efg->NumPlayers(); pl++) {
-	ov->SetPayoff(pl, lexical_cast<std::string>(subval[pl]));
-      }
- 
-      values.Append(ov);
+    int i = m_children.Length();
+    while (i >= 1 && ++choice[i] > m_children[i]->m_solutions.Length()) {
+      choice[i--] = 1;
     }
-    //printf("Finished with scenario %d of %d; total solutions so far = %d\n",
-    //soln, thissolns.Length(), solns.Length());
+    if (i == 0)  break;
   }
-
-  n->DeleteTree();
 }
 
 template <class T, typename SolverType>
 List<MixedBehavProfile<T> > 
 SolveBySubgames(const BehavSupport &p_support,
-		SolverType p_solver)
+		SolverType p_solver, int p_threads)
 {
-  Game efg = CopyGame(p_support.GetGame(), p_support.GetGame()->GetRoot());
+  Game efg = p_support.GetGame()->Copy();
 
   for (int pl = 1; pl <= efg->NumPlayers(); pl++) {
     for (int iset = 1; iset <= efg->GetPlayer(pl)->NumInfosets(); iset++) {
@@ -259,16 +283,17 @@ SolveBySubgames(const BehavSupport &p_support,
     }
   }
 
-  List<DVector<T> > vectors;
-  List<GameOutcome> values;
-  SolveSubgames(support, DVector<T>(support.NumActions()),
-		p_solver, efg->GetRoot(), vectors, values);
+  DVector<T> templateSolution(support.NumActions());
+  WorkPool pool(p_threads);
+  SubgameTask<T, SolverType> task(pool, efg, templateSolution, p_solver);
+  efg = 0;
+  task.Run();
 
   List<MixedBehavProfile<T> > solutions;
-  for (int i = 1; i <= vectors.Length(); i++) {
+  for (int i = 1; i <= task.m_solutions.Length(); i++) {
     solutions.Append(MixedBehavProfile<T>(p_support));
-    for (int j = 1; j <= vectors[i].Length(); j++) {
-      solutions[i][j] = vectors[i][j];
+    for (int j = 1; j <= task.m_solutions[i].Length(); j++) {
+      solutions[i][j] = task.m_solutions[i][j];
     }
   }
   return solutions;
@@ -281,9 +306,11 @@ SolveBySubgames(const BehavSupport &p_support,
 //
 
 template List<MixedBehavProfile<double> > 
-SolveBySubgames(const BehavSupport &p_support, DoubleSolver p_solver);
+SolveBySubgames(const BehavSupport &p_support, DoubleSolver p_solver,
+		int p_threads);
 
 template List<MixedBehavProfile<Rational> > 
-SolveBySubgames(const BehavSupport &p_support, RationalSolver p_solver);
+SolveBySubgames(const BehavSupport &p_support, RationalSolver p_solver,
+		int p_threads);
 
 } // end namespace Gambit
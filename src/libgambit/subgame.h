@@ -30,9 +30,14 @@ typedef List<MixedBehavProfile<double> > (*DoubleSolver)(const BehavSupport &p_s
 typedef List<MixedBehavProfile<Rational> > (*RationalSolver)(const BehavSupport &p_support);
 
 
+/// Finds the subgame-perfect equilibria obtained by solving each proper
+/// subgame with p_solver, working up from the smallest.  Sibling
+/// subgames are solved concurrently, on p_threads threads (by default,
+/// one per processor).
 template <class T, typename SolverType>
 List<MixedBehavProfile<T> > SolveBySubgames(const BehavSupport &p_support,
-					    SolverType p_solver);
+					    SolverType p_solver,
+					    int p_threads = 0);
 
 }
 
@@ -0,0 +1,240 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/workpool.cc
+// A pool of threads for running independent computations
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifdef HAVE_PTHREAD_H
+#include <pthread.h>
+#endif  // HAVE_PTHREAD_H
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif  // HAVE_UNISTD_H
+
+#include "workpool.h"
+
+namespace Gambit {
+
+//========================================================================
+//                           class WorkPool
+//========================================================================
+
+/// The platform-specific state of the pool.  A single lock protects
+/// the queues and the groups, and a single condition is signalled
+/// whenever a task is queued or completed; tasks are expected to be
+/// coarse enough that contention for these is not significant.
+struct WorkPool::Threads {
+#ifdef HAVE_PTHREAD_H
+  std::vector<pthread_t> m_ids;
+  pthread_mutex_t m_mutex;
+  pthread_cond_t m_changed;
+#endif  // HAVE_PTHREAD_H
+};
+
+WorkPool::WorkPool(int p_threads)
+  : m_threads(new Threads), m_shutdown(false)
+{
+  if (p_threads <= 0) {
+    p_threads = NumProcessors();
+  }
+
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_init(&m_threads->m_mutex, 0);
+  pthread_cond_init(&m_threads->m_changed, 0);
+
+  // The workers find their queues from the list of thread ids, so
+  // they are held back until the list is complete
+  Lock();
+  for (int i = 1; i < p_threads; i++) {
+    pthread_t id;
+    if (pthread_create(&id, 0, ThreadMain, this) != 0)  break;
+    m_threads->m_ids.push_back(id);
+  }
+  m_queues.resize(m_threads->m_ids.size() + 1);
+  Unlock();
+#else
+  m_queues.resize(1);
+#endif  // HAVE_PTHREAD_H
+}
+
+WorkPool::~WorkPool()
+{
+#ifdef HAVE_PTHREAD_H
+  Lock();
+  m_shutdown = true;
+  NotifyChange();
+  Unlock();
+  for (size_t i = 0; i < m_threads->m_ids.size(); i++) {
+    pthread_join(m_threads->m_ids[i], 0);
+  }
+  pthread_cond_destroy(&m_threads->m_changed);
+  pthread_mutex_destroy(&m_threads->m_mutex);
+#endif  // HAVE_PTHREAD_H
+  delete m_threads;
+}
+
+int WorkPool::NumProcessors(void)
+{
+#if defined(HAVE_PTHREAD_H) && defined(_SC_NPROCESSORS_ONLN)
+  long processors = sysconf(_SC_NPROCESSORS_ONLN);
+  return (processors > 0) ? (int) processors : 1;
+#else
+  return 1;
+#endif
+}
+
+void WorkPool::Lock(void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_lock(&m_threads->m_mutex);
+#endif  // HAVE_PTHREAD_H
+}
+
+void WorkPool::Unlock(void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_mutex_unlock(&m_threads->m_mutex);
+#endif  // HAVE_PTHREAD_H
+}
+
+void WorkPool::WaitForChange(void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_cond_wait(&m_threads->m_changed, &m_threads->m_mutex);
+#endif  // HAVE_PTHREAD_H
+}
+
+void WorkPool::NotifyChange(void)
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_cond_broadcast(&m_threads->m_changed);
+#endif  // HAVE_PTHREAD_H
+}
+
+int WorkPool::CurrentQueue(void) const
+{
+#ifdef HAVE_PTHREAD_H
+  pthread_t self = pthread_self();
+  for (size_t i = 0; i < m_threads->m_ids.size(); i++) {
+    if (pthread_equal(m_threads->m_ids[i], self))  return i + 1;
+  }
+#endif  // HAVE_PTHREAD_H
+  return 0;
+}
+
+bool WorkPool::RunQueued(int p_queue)
+{
+  Item item;
+  if (!m_queues[p_queue].empty()) {
+    item = m_queues[p_queue].back();
+    m_queues[p_queue].pop_back();
+  }
+  else {
+    int victim = p_queue;
+    for (size_t i = 1; i < m_queues.size(); i++) {
+      int queue = (p_queue + i) % m_queues.size();
+      if (!m_queues[queue].empty()) {
+	victim = queue;
+	break;
+      }
+    }
+    if (victim == p_queue)  return false;
+    item = m_queues[victim].front();
+    m_queues[victim].pop_front();
+  }
+
+  Unlock();
+  bool failed = false;
+  std::string message;
+  try {
+    item.m_task->Run();
+  }
+  catch (std::exception &e) {
+    failed = true;
+    message = e.what();
+  }
+  catch (...) {
+    failed = true;
+    message = "Unknown error in task";
+  }
+  Lock();
+
+  WorkGroup *group = item.m_group;
+  if (failed && !group->m_failed) {
+    group->m_failed = true;
+    group->m_message = message;
+  }
+  group->m_pending--;
+  NotifyChange();
+  return true;
+}
+
+void *WorkPool::ThreadMain(void *p_pool)
+{
+  WorkPool *pool = static_cast<WorkPool *>(p_pool);
+  pool->Lock();
+  int queue = pool->CurrentQueue();
+  while (!pool->m_shutdown) {
+    if (!pool->RunQueued(queue)) {
+      pool->WaitForChange();
+    }
+  }
+  pool->Unlock();
+  return 0;
+}
+
+//========================================================================
+//                           class WorkGroup
+//========================================================================
+
+void WorkGroup::Submit(WorkTask *p_task)
+{
+  WorkPool::Item item;
+  item.m_task = p_task;
+  item.m_group = this;
+
+  m_pool.Lock();
+  m_pool.m_queues[m_pool.CurrentQueue()].push_back(item);
+  m_pending++;
+  m_pool.NotifyChange();
+  m_pool.Unlock();
+}
+
+void WorkGroup::Complete(void)
+{
+  m_pool.Lock();
+  int queue = m_pool.CurrentQueue();
+  while (m_pending > 0) {
+    if (!m_pool.RunQueued(queue)) {
+      m_pool.WaitForChange();
+    }
+  }
+  m_pool.Unlock();
+}
+
+void WorkGroup::Wait(void)
+{
+  Complete();
+  if (m_failed) {
+    m_failed = false;
+    throw TaskFailedException(m_message);
+  }
+}
+
+}  // end namespace Gambit
@@ -0,0 +1,142 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/libgambit/workpool.h
+// A pool of threads for running independent computations
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef LIBGAMBIT_WORKPOOL_H
+#define LIBGAMBIT_WORKPOOL_H
+
+#include <deque>
+#include <vector>
+
+#include "libgambit.h"
+
+namespace Gambit {
+
+//
+// A WorkPool runs tasks on a fixed set of threads.  Each thread has its
+// own queue of tasks: it takes the task it queued most recently, and
+// when its queue is empty it steals the oldest task queued by another
+// thread.  A thread waiting for a group of tasks to complete runs queued
+// tasks in the meantime, so tasks may themselves submit and wait for
+// further tasks, as in a recursive decomposition.
+//
+// Tasks run concurrently must not share any game objects, since
+// reference counts on these are not synchronized.
+//
+// Where threads are not available, or when the pool has a single
+// thread, tasks are run by the thread waiting for them.
+//
+
+/// A unit of work to be run by a WorkPool
+class WorkTask {
+public:
+  virtual ~WorkTask() { }
+  /// Performs the work of the task
+  virtual void Run(void) = 0;
+};
+
+/// Exception thrown when waiting on a group in which a task has failed
+class TaskFailedException : public Exception {
+private:
+  std::string m_message;
+
+public:
+  TaskFailedException(const std::string &p_message)
+    : m_message(p_message) { }
+  virtual ~TaskFailedException() throw() { }
+  const char *what(void) const throw() { return m_message.c_str(); }
+};
+
+class WorkGroup;
+
+class WorkPool {
+  friend class WorkGroup;
+private:
+  struct Item {
+    WorkTask *m_task;
+    WorkGroup *m_group;
+  };
+  struct Threads;
+
+  std::vector<std::deque<Item> > m_queues;
+  Threads *m_threads;
+  bool m_shutdown;
+
+  /// Returns the queue of the calling thread; threads outside the
+  /// pool share the first queue
+  int CurrentQueue(void) const;
+  /// Runs one queued task, preferring the given queue; returns false
+  /// if no task is queued.  Must be called with the pool locked.
+  bool RunQueued(int p_queue);
+  /// Blocks until a task is queued or completed.  Must be called with
+  /// the pool locked.
+  void WaitForChange(void);
+  /// Wakes the threads blocked in WaitForChange()
+  void NotifyChange(void);
+
+  void Lock(void);
+  void Unlock(void);
+
+  static void *ThreadMain(void *);
+
+public:
+  /// Starts a pool with the given number of threads, including the
+  /// thread which waits for tasks; if zero, one per processor
+  WorkPool(int p_threads = 0);
+  /// Stops the threads; there must be no tasks outstanding
+  ~WorkPool();
+
+  /// Returns the number of threads which run tasks
+  int NumThreads(void) const { return m_queues.size(); }
+  /// Returns the number of processors available, or one if unknown
+  static int NumProcessors(void);
+};
+
+/// A set of tasks submitted to a pool, whose completion is waited for
+/// together
+class WorkGroup {
+  friend class WorkPool;
+private:
+  WorkPool &m_pool;
+  int m_pending;
+  bool m_failed;
+  std::string m_message;
+
+  /// Waits for the tasks without reporting failures
+  void Complete(void);
+
+public:
+  WorkGroup(WorkPool &p_pool)
+    : m_pool(p_pool), m_pending(0), m_failed(false) { }
+  /// Waits for any tasks still outstanding
+  ~WorkGroup() { Complete(); }
+
+  /// Queues the task.  The task remains owned by the caller, and
+  /// must not be destroyed before the group has completed.
+  void Submit(WorkTask *p_task);
+  /// Runs or waits for tasks until every task in the group has
+  /// completed; throws a TaskFailedException if any task threw
+  void Wait(void);
+};
+
+}  // end namespace Gambit
+
+#endif  // LIBGAMBIT_WORKPOOL_H
@@ -23,6 +23,7 @@
 #ifndef LUDECOMP_H
 #define LUDECOMP_H
 
+#include <vector>
 #include "libgambit/libgambit.h"
 #include "basis.h"
 
@@ -36,9 +37,9 @@ template <class T> class EtaMatrix {
   public:
   int col;
   Gambit::Vector<T> etadata;
+  std::vector<int> nonzeros;  // indexes of nonzero entries, in order
   
-  
-  EtaMatrix(int c, Gambit::Vector<T> &v) : col(c), etadata(v) {};
+  EtaMatrix(int c, Gambit::Vector<T> &v);
 
 // required for list class
 bool operator==(const EtaMatrix<T> &) const;
@@ -70,7 +71,9 @@ private:
   int total_operations;
 
   const LUdecomp<T> *parent;
-  int copycount;
+  // The number of copies referring to this decomposition.  Copies of
+  // one decomposition may be made and released by different threads.
+  mutable int copycount;
 
   // don't use this copy constructor
   LUdecomp( const LUdecomp<T> &a);
@@ -153,18 +156,18 @@ private:
   void LPd_Trans( Gambit::Vector<T> & ) const;
   void yLP_Trans( Gambit::Vector<T> & ) const;
 
-  void VectorEtaSolve( const Gambit::Vector<T> &v,  
-		      const EtaMatrix<T> &, 
-		      Gambit::Vector<T> &y ) const;
+  // These apply a single eta matrix in place, touching only the
+  // nonzero entries of the eta column
+  void VectorEtaSolve( const EtaMatrix<T> &, Gambit::Vector<T> &y ) const;
 
-  void EtaVectorSolve( const Gambit::Vector<T> &v, 
-		      const EtaMatrix<T> &,
-		      Gambit::Vector<T> &d ) const;
+  void EtaVectorSolve( const EtaMatrix<T> &, Gambit::Vector<T> &d ) const;
 
-  void yLP_mult( const Gambit::Vector<T> &y, int j, Gambit::Vector<T> &) const;
+  void yLP_mult( Gambit::Vector<T> &y, int j ) const;
 
-  void LPd_mult( Gambit::Vector<T> &d, int j, Gambit::Vector<T> &) const;
+  void LPd_mult( Gambit::Vector<T> &d, int j ) const;
 
+  void AddCopy() const;
+  void RemoveCopy() const;
 
 };  // end of class LUdecomp
     
@@ -0,0 +1,120 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/liblinear/sparselp.h
+// Interface to sparse LP solver
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef SPARSELP_H
+#define SPARSELP_H
+
+#include <vector>
+#include "libgambit/libgambit.h"
+#include "liblinear/sparsematrix.h"
+#include "liblinear/bfs.h"
+
+//
+// A revised simplex solver for the same problems as LPSolve: maximize
+// c x subject to A x <= b and x >= 0, where the last 'nequals' rows
+// of A hold with equality.  The matrix is given in sparse form.
+//
+// The inverse of the basis is kept as a product of elementary (eta)
+// matrices, which is rebuilt from the columns of the basis every so
+// many pivots.  Only the nonzero entries of A and of the eta columns
+// are stored, so the memory used, and most of the work of a pivot,
+// grow with the number of nonzeros rather than with the size of A.
+//
+// A first feasible basis is found by adding artificial variables for
+// the rows whose slacks cannot start in the basis.  The entering
+// variable is the one of largest reduced cost, except after a long run
+// of degenerate pivots, where the smallest-index rule is used so that
+// the method cannot cycle.
+//
+// All computation is done in the constructor.
+//
+template <class T> class SparseLPSolve {
+public:
+  SparseLPSolve(const SparseMatrix<T> &A, const Gambit::Vector<T> &b,
+		const Gambit::Vector<T> &c, int nequals);
+
+  bool IsFeasible(void) const { return m_feasible; }
+  bool IsBounded(void) const { return m_bounded; }
+  long NumPivots(void) const { return m_numPivots; }
+  T OptimumCost(void) const { return m_cost; }
+
+  /// Writes the optimal basic solution in the format of LPSolve:
+  /// the basic columns are labelled by their index in A, and the
+  /// dual values of the rows whose slacks are not basic by minus the
+  /// index of the row
+  void OptBFS(BFS<T> &) const;
+
+private:
+  const SparseMatrix<T> &m_A;
+  int m_numRows, m_numCols, m_numEquals;
+  bool m_feasible, m_bounded;
+  long m_numPivots;
+  T m_cost, m_tolerance;
+  std::vector<T> m_rhs;
+
+  // The variables are numbered with the columns of A first, then the
+  // slack of each row, then the artificial of each row.  Nonbasic
+  // variables are at zero; fixed variables may not enter the basis.
+  std::vector<T> m_objective, m_sign;
+  std::vector<char> m_fixed;
+  // The basic variable of each row, and its value; the row of each
+  // variable in the basis, or -1 if it is not basic
+  std::vector<int> m_basis, m_position;
+  std::vector<T> m_values;
+
+  // The eta file: each eta is the pivot row, and the column of the
+  // pivot given by its value at the pivot row and its other nonzeros
+  std::vector<int> m_etaRow, m_etaStart, m_etaIndex;
+  std::vector<T> m_etaPivot, m_etaValue;
+  // The number of pivots since the eta file was rebuilt
+  int m_numUpdates;
+
+  // Work vectors for the transforms, and the rows in which the column
+  // being transformed may be nonzero
+  std::vector<T> m_column, m_dual;
+  std::vector<int> m_pattern;
+  std::vector<char> m_marked;
+
+  /// Sets the entry of m_column, which must be zero
+  void LoadEntry(int p_row, const T &p_value);
+  /// Loads the column of the variable into m_column
+  void LoadColumn(int p_var);
+  /// Clears m_column, leaving it zero
+  void ClearColumn(void);
+  /// Replaces m_column by the inverse of the basis times it
+  void Ftran(void);
+  /// Computes the row vector of costs of the basic variables times
+  /// the inverse of the basis into m_dual
+  void Btran(void);
+  /// Appends the eta for pivoting m_column in at the row
+  void AddEta(int p_row);
+  /// Returns the reduced cost of the nonbasic variable
+  T ReducedCost(int p_var) const;
+
+  /// Rebuilds the eta file from the current basis, and recomputes the
+  /// values of the basic variables
+  void Refactor(void);
+  /// Pivots until the objective in m_objective is optimal
+  void Optimize(bool p_phaseOne);
+};
+
+#endif  // SPARSELP_H
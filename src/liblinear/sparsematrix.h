@@ -0,0 +1,99 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/liblinear/sparsematrix.h
+// Interface to sparse matrix class
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef SPARSEMATRIX_H
+#define SPARSEMATRIX_H
+
+#include <vector>
+#include "libgambit/libgambit.h"
+
+//
+// A matrix stored by columns, holding only its nonzero entries.
+//
+// Entries are written in any order with Add() and Set(), which have
+// the same effect as the corresponding sequence of operations on a
+// dense matrix, and which are merged into compressed columns the
+// first time the matrix is read.  Entries in a column are held in
+// increasing order of row.
+//
+template <class T> class SparseMatrix {
+private:
+  struct Entry {
+    int m_row, m_col;
+    T m_value;
+    bool m_replace;
+  };
+
+  int m_minrow, m_maxrow, m_mincol, m_maxcol;
+
+  mutable std::vector<Entry> m_pending;
+  mutable std::vector<int> m_colStart;
+  mutable std::vector<int> m_rows;
+  mutable std::vector<T> m_values;
+
+  void Write(int p_row, int p_col, const T &p_value, bool p_replace);
+  /// Merges the pending entries into the compressed columns
+  void Compress(void) const;
+
+public:
+  class BadIndex : public Gambit::Exception  {
+  public:
+    virtual ~BadIndex() throw() { }
+    const char *what(void) const throw() { return "Index out of range in SparseMatrix"; }
+  };
+
+  /// Constructs a matrix of zeros
+  SparseMatrix(int p_minrow, int p_maxrow, int p_mincol, int p_maxcol);
+
+  int MinRow(void) const { return m_minrow; }
+  int MaxRow(void) const { return m_maxrow; }
+  int MinCol(void) const { return m_mincol; }
+  int MaxCol(void) const { return m_maxcol; }
+
+  /// Adds p_value to the entry
+  void Add(int p_row, int p_col, const T &p_value)
+  { Write(p_row, p_col, p_value, false); }
+  /// Replaces the entry with p_value
+  void Set(int p_row, int p_col, const T &p_value)
+  { Write(p_row, p_col, p_value, true); }
+
+  /// Returns the number of nonzero entries
+  int NumNonzeros(void) const;
+
+  /// Returns the position of the first nonzero entry in the column;
+  /// the entries of the column are at positions ColumnStart(col) up to,
+  /// but not including, ColumnStart(col+1)
+  int ColumnStart(int p_col) const;
+  /// Returns the row of the entry at the position
+  int GetRow(int p_index) const { return m_rows[p_index]; }
+  /// Returns the value of the entry at the position
+  const T &GetValue(int p_index) const { return m_values[p_index]; }
+
+  /// Returns the entry, which is zero if not stored
+  T operator()(int p_row, int p_col) const;
+  /// Writes the column into a dense vector indexed by row
+  void GetColumn(int p_col, Gambit::Vector<T> &) const;
+  /// Writes the matrix into a dense matrix of the same dimensions
+  void GetDense(Gambit::Matrix<T> &) const;
+};
+
+#endif  // SPARSEMATRIX_H
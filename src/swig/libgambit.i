@@ -202,6 +202,7 @@ using namespace Gambit;
 %ignore *::operator!;
 
 %rename(is_tree) Gambit::GameRep::IsTree;
+%ignore Gambit::GameOutcomeRep::SetPayoff(int, const Number &);
 
 %include <libgambit/game.h>
 
@@ -273,6 +274,7 @@ using namespace Gambit;
 %ignore Gambit::GameRep::GameRep(const Array<int> &);
 %ignore Gambit::GameRep::WriteEfgFile(std::ostream &);
 %ignore Gambit::GameRep::WriteNfgFile(std::ostream &);
+%ignore Gambit::GameRep::WriteSnapshotFile(std::ostream &);
 
 %extend Gambit::GameRep {
   std::string efg_file(void) const
@@ -292,6 +294,13 @@ using namespace Gambit;
     return s.str();
   }
 
+  std::string snapshot_file(void) const
+  {
+    std::ostringstream s;
+    self->WriteSnapshotFile(s);
+    return s.str();
+  }
+
   MixedStrategyProfile<double> NewMixedStrategyDouble(void)
   { return MixedStrategyProfile<double>(StrategySupport(self)); }
 
@@ -355,6 +364,7 @@ using namespace Gambit;
 //
 
 %ignore Gambit::ReadGame(std::istream &) throw(InvalidFileException);
+%ignore Gambit::ReadGame(const char *, const char *) throw(InvalidFileException);
 
 %{
 Gambit::Game ReadGameString(const std::string &p_string)
@@ -12,13 +12,16 @@ libgambit_ext = Extension("gambit._libgambit",
                             "../libgambit/integer.cc",
                             "../libgambit/matrix.cc",
                             "../libgambit/mixed.cc",
+                            "../libgambit/number.cc",
                             "../libgambit/pvector.cc",
                             "../libgambit/rational.cc",
+                            "../libgambit/snapshot.cc",
                             "../libgambit/sqmatrix.cc",
                             "../libgambit/stratitr.cc",
                             "../libgambit/stratspt.cc",
                             "../libgambit/subgame.cc",
-                            "../libgambit/vector.cc" ],
+                            "../libgambit/vector.cc",
+                            "../libgambit/workpool.cc" ],
                           include_dirs=[".."])
                           
 
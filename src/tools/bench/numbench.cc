@@ -0,0 +1,349 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/bench/numbench.cc
+// Micro-benchmarks for the arbitrary-precision number classes
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <unistd.h>
+#include <cstdlib>
+#include <cctype>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+#include "libgambit/libgambit.h"
+
+using namespace Gambit;
+
+//
+// numbench times the Integer and Rational operations the exact solvers
+// depend on.  Each kernel is run twice: once with Integer and Rational,
+// which hold machine-word values inline, and once with a reference
+// implementation which holds every value in a heap-allocated IntegerRep
+// and normalizes rationals with a full gcd, as Integer and Rational did
+// before values were held inline.  The two must compute the same result.
+//
+// The program accepts the following command-line options:
+// -n COUNT: Number of iterations of each kernel (default 200000)
+// -b BITS:  Size of the operands, in bits (default 20).  Operands of
+//           more than about 30 bits overflow a word in the products
+//           and exercise the arbitrary-precision code.
+// -q:       Quiet mode (suppresses banner)
+//
+
+//========================================================================
+//                  Reference (heap-allocated) implementation
+//========================================================================
+
+/// An integer which always holds its value in an IntegerRep
+class RepInteger {
+public:
+  IntegerRep *rep;
+
+  RepInteger(long x = 0) : rep(Icopy_long(0, x)) { }
+  explicit RepInteger(IntegerRep *r) : rep(r) { }
+  RepInteger(const RepInteger &x) : rep(Icopy(0, x.rep)) { }
+  ~RepInteger() { if (!STATIC_IntegerRep(rep)) delete rep; }
+
+  RepInteger &operator=(const RepInteger &x)
+  { rep = Icopy(rep, x.rep);  return *this; }
+};
+
+/// A rational which normalizes with a full gcd after each operation
+class RepRational {
+public:
+  RepInteger num, den;
+
+  RepRational(long n = 0, long d = 1) : num(n), den(d) { Normalize(); }
+
+  void Normalize(void)
+  {
+    if (den.rep->sgn == 0) {
+      den.rep = negate(den.rep, den.rep);
+      num.rep = negate(num.rep, num.rep);
+    }
+    RepInteger g(gcd(num.rep, den.rep));
+    if (ucompare(g.rep, 1) != 0) {
+      num.rep = div(num.rep, g.rep, num.rep);
+      den.rep = div(den.rep, g.rep, den.rep);
+    }
+  }
+};
+
+void Add(const RepRational &x, const RepRational &y, RepRational &r)
+{
+  RepInteger tmp;
+  tmp.rep = multiply(x.den.rep, y.num.rep, tmp.rep);
+  r.num.rep = multiply(x.num.rep, y.den.rep, r.num.rep);
+  r.num.rep = add(r.num.rep, 0, tmp.rep, 0, r.num.rep);
+  r.den.rep = multiply(x.den.rep, y.den.rep, r.den.rep);
+  r.Normalize();
+}
+
+void Sub(const RepRational &x, const RepRational &y, RepRational &r)
+{
+  RepInteger tmp;
+  tmp.rep = multiply(x.den.rep, y.num.rep, tmp.rep);
+  r.num.rep = multiply(x.num.rep, y.den.rep, r.num.rep);
+  r.num.rep = add(r.num.rep, 0, tmp.rep, 1, r.num.rep);
+  r.den.rep = multiply(x.den.rep, y.den.rep, r.den.rep);
+  r.Normalize();
+}
+
+void Mul(const RepRational &x, const RepRational &y, RepRational &r)
+{
+  r.num.rep = multiply(x.num.rep, y.num.rep, r.num.rep);
+  r.den.rep = multiply(x.den.rep, y.den.rep, r.den.rep);
+  r.Normalize();
+}
+
+void Div(const RepRational &x, const RepRational &y, RepRational &r)
+{
+  RepInteger tmp;
+  tmp.rep = multiply(x.num.rep, y.den.rep, tmp.rep);
+  r.den.rep = multiply(y.num.rep, x.den.rep, r.den.rep);
+  r.num = tmp;
+  r.Normalize();
+}
+
+std::string ToText(const Integer &x) { return lexical_cast<std::string>(x); }
+std::string ToText(const Rational &x) { return lexical_cast<std::string>(x); }
+std::string ToText(const RepInteger &x) { return Itoa(x.rep); }
+
+std::string ToText(const RepRational &x)
+{
+  if (ucompare(x.den.rep, 1) == 0)  return Itoa(x.num.rep);
+  return Itoa(x.num.rep) + "/" + Itoa(x.den.rep);
+}
+
+//========================================================================
+//                           The kernels
+//========================================================================
+
+//
+// Each kernel is written once, as a template on the number types, so
+// that both implementations do exactly the same sequence of operations.
+// The operands are drawn from a fixed table of pseudo-random values.
+//
+
+const int c_numOperands = 64;
+long g_operands[c_numOperands];
+
+void FillOperands(int p_bits)
+{
+  srand(1);
+  long bound = (p_bits >= 31) ? 2147483647L : (1L << p_bits);
+  for (int i = 0; i < c_numOperands; i++) {
+    long x = 1 + (long) ((double) rand() / RAND_MAX * (bound - 1));
+    g_operands[i] = (i % 3 == 0) ? -x : x;
+  }
+}
+
+inline void Sum(const Integer &x, const Integer &y, Integer &r)
+{ add(x, y, r); }
+inline void Sum(const RepInteger &x, const RepInteger &y, RepInteger &r)
+{ r.rep = add(x.rep, 0, y.rep, 0, r.rep); }
+inline void Product(const Integer &x, const Integer &y, Integer &r)
+{ mul(x, y, r); }
+inline void Product(const RepInteger &x, const RepInteger &y, RepInteger &r)
+{ r.rep = multiply(x.rep, y.rep, r.rep); }
+inline void Remainder(const Integer &x, const Integer &y, Integer &r)
+{ mod(x, y, r); }
+inline void Remainder(const RepInteger &x, const RepInteger &y, RepInteger &r)
+{ r.rep = mod(x.rep, y.rep, r.rep); }
+
+inline void Sum(const Rational &x, const Rational &y, Rational &r)
+{ add(x, y, r); }
+inline void Sum(const RepRational &x, const RepRational &y, RepRational &r)
+{ Add(x, y, r); }
+inline void Difference(const Rational &x, const Rational &y, Rational &r)
+{ sub(x, y, r); }
+inline void Difference(const RepRational &x, const RepRational &y, RepRational &r)
+{ Sub(x, y, r); }
+inline void Product(const Rational &x, const Rational &y, Rational &r)
+{ mul(x, y, r); }
+inline void Product(const RepRational &x, const RepRational &y, RepRational &r)
+{ Mul(x, y, r); }
+inline void Quotient(const Rational &x, const Rational &y, Rational &r)
+{ div(x, y, r); }
+inline void Quotient(const RepRational &x, const RepRational &y, RepRational &r)
+{ Div(x, y, r); }
+
+/// Integer multiply-accumulate, reduced modulo an operand to keep
+/// the accumulator the size of the operands
+template <class Z> std::string IntegerMulAdd(int p_count)
+{
+  Z acc(1), prod, modulus(g_operands[0]);
+  Z a[c_numOperands];
+  for (int i = 0; i < c_numOperands; i++)  a[i] = Z(g_operands[i]);
+  for (int i = 0; i < p_count; i++) {
+    Product(a[i % c_numOperands], a[(i + 7) % c_numOperands], prod);
+    Sum(acc, prod, acc);
+    Remainder(acc, modulus, acc);
+  }
+  return ToText(acc);
+}
+
+/// Rational sum of a sequence of small fractions
+template <class Q> std::string RationalSum(int p_count)
+{
+  Q acc(0), term;
+  for (int i = 0; i < p_count; i++) {
+    term = Q(g_operands[i % c_numOperands],
+	     1 + (g_operands[(i + 1) % c_numOperands] & 255));
+    Sum(acc, term, acc);
+    if (i % 16 == 15)  acc = Q(0);
+  }
+  return ToText(acc);
+}
+
+/// The update done for each entry in a tableau pivot,
+/// y = x - (r * c) / p, over a fixed row of entries
+template <class Q> std::string PivotUpdate(int p_count)
+{
+  Q row[c_numOperands], result, prod, quot;
+  for (int i = 0; i < c_numOperands; i++) {
+    row[i] = Q(g_operands[i], 1 + (g_operands[(i + 3) % c_numOperands] & 15));
+  }
+  Q pivot(g_operands[5], 7L);
+  for (int i = 0; i < p_count; i++) {
+    int j = i % c_numOperands;
+    Product(row[(j + 1) % c_numOperands], row[(j + 2) % c_numOperands], prod);
+    Quotient(prod, pivot, quot);
+    Difference(row[j], quot, result);
+  }
+  return ToText(result);
+}
+
+//========================================================================
+//                         Timing and reporting
+//========================================================================
+
+typedef std::string (*Kernel)(int);
+
+double Time(Kernel p_kernel, int p_count, std::string &p_result)
+{
+  clock_t start = clock();
+  p_result = p_kernel(p_count);
+  return (double) (clock() - start) / CLOCKS_PER_SEC;
+}
+
+bool Report(const std::string &p_label, Kernel p_inline, Kernel p_reference,
+	    int p_count)
+{
+  std::string inlineResult, referenceResult;
+  double inlineTime = Time(p_inline, p_count, inlineResult);
+  double referenceTime = Time(p_reference, p_count, referenceResult);
+
+  std::cout << std::setw(16) << std::left << p_label << std::right;
+  std::cout << std::setw(12) << std::fixed << std::setprecision(1)
+	    << 1.0e9 * inlineTime / p_count;
+  std::cout << std::setw(12) << 1.0e9 * referenceTime / p_count;
+  if (inlineTime > 0.0) {
+    std::cout << std::setw(10) << std::setprecision(2)
+	      << referenceTime / inlineTime << "x";
+  }
+  std::cout << std::endl;
+
+  if (inlineResult != referenceResult) {
+    std::cerr << p_label << ": results differ: " << inlineResult
+	      << " != " << referenceResult << std::endl;
+    return false;
+  }
+  return true;
+}
+
+void PrintBanner(std::ostream &p_stream)
+{
+  p_stream << "Benchmark arbitrary-precision number operations\n";
+  p_stream << "Gambit version " VERSION ", Copyright (C) 1994-2010, The Gambit Project\n";
+  p_stream << "This is free software, distributed under the GNU GPL\n\n";
+}
+
+void PrintHelp(char *progname)
+{
+  PrintBanner(std::cerr);
+  std::cerr << "Usage: " << progname << " [OPTIONS]\n";
+  std::cerr << "Times Integer and Rational operations against a reference\n";
+  std::cerr << "implementation which holds all values in heap storage.\n\n";
+
+  std::cerr << "Options:\n";
+  std::cerr << "  -b BITS          size of operands in bits (default is 20)\n";
+  std::cerr << "  -h               print this help message\n";
+  std::cerr << "  -n COUNT         iterations of each kernel (default is 200000)\n";
+  std::cerr << "  -q               quiet mode (suppresses banner)\n";
+  exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+  opterr = 0;
+  int count = 200000, bits = 20;
+  bool quiet = false;
+
+  int c;
+  while ((c = getopt(argc, argv, "b:hn:q")) != -1) {
+    switch (c) {
+    case 'b':
+      bits = atoi(optarg);
+      break;
+    case 'h':
+      PrintHelp(argv[0]);
+      break;
+    case 'n':
+      count = atoi(optarg);
+      break;
+    case 'q':
+      quiet = true;
+      break;
+    case '?':
+      if (isprint(optopt)) {
+	std::cerr << argv[0] << ": Unknown option `-" << ((char) optopt) << "'.\n";
+      }
+      else {
+	std::cerr << argv[0] << ": Unknown option character `\\x" << optopt << "`.\n";
+      }
+      return 1;
+    default:
+      abort();
+    }
+  }
+
+  if (!quiet) {
+    PrintBanner(std::cerr);
+  }
+
+  if (bits < 1 || count < 1) {
+    std::cerr << argv[0] << ": operand size and count must be positive\n";
+    return 1;
+  }
+  FillOperands(bits);
+
+  std::cout << std::setw(16) << std::left << "kernel" << std::right;
+  std::cout << std::setw(12) << "inline ns" << std::setw(12) << "heap ns";
+  std::cout << std::setw(11) << "speedup" << std::endl;
+
+  bool ok = true;
+  ok = Report("integer-muladd", IntegerMulAdd<Integer>,
+	      IntegerMulAdd<RepInteger>, count) && ok;
+  ok = Report("rational-sum", RationalSum<Rational>,
+	      RationalSum<RepRational>, count) && ok;
+  ok = Report("pivot-update", PivotUpdate<Rational>,
+	      PivotUpdate<RepRational>, count) && ok;
+  return (ok) ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/cfr/cfr.cc
+// Compute approximate equilibria by counterfactual regret minimization
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <unistd.h>
+#include "libgambit/libgambit.h"
+#include "efgcfr.h"
+
+using namespace Gambit;
+
+int g_numDecimals = 6;
+
+void PrintBanner(std::ostream &p_stream)
+{
+  p_stream << "Compute approximate equilibria by counterfactual regret minimization\n";
+  p_stream << "Gambit version " VERSION ", Copyright (C) 1994-2010, The Gambit Project\n";
+  p_stream << "This is free software, distributed under the GNU GPL\n\n";
+}
+
+void PrintHelp(char *progname)
+{
+  PrintBanner(std::cerr);
+  std::cerr << "Usage: " << progname << " [OPTIONS]\n";
+  std::cerr << "Accepts extensive game on standard input.\n";
+
+  std::cerr << "Options:\n";
+  std::cerr << "  -c FILE          write a checkpoint to FILE when finished\n";
+  std::cerr << "  -d DECIMALS      print probabilities with DECIMALS digits\n";
+  std::cerr << "  -e TOL           stop when the exploitability is at most TOL\n";
+  std::cerr << "  -h               print this help message\n";
+  std::cerr << "  -k COUNT         also write the checkpoint every COUNT iterations\n";
+  std::cerr << "  -n COUNT         run until COUNT iterations in all (default 1000)\n";
+  std::cerr << "  -p               use CFR+ rather than the original CFR\n";
+  std::cerr << "  -q               quiet mode (suppresses banner)\n";
+  std::cerr << "  -r FILE          resume from the checkpoint in FILE\n";
+  std::cerr << "  -t THREADS       number of threads (default is one per processor)\n";
+  std::cerr << "  -v               print the exploitability after each iteration\n";
+  exit(1);
+}
+
+void PrintProfile(std::ostream &p_stream,
+		  const std::string &p_label,
+		  const MixedBehavProfile<double> &p_profile)
+{
+  p_stream << p_label;
+  for (int i = 1; i <= p_profile.Length(); i++) {
+    p_stream.setf(std::ios::fixed);
+    p_stream << "," << std::setprecision(g_numDecimals) << p_profile[i];
+  }
+
+  p_stream << std::endl;
+}
+
+bool WriteCheckpoint(const EfgCfr &p_solver, const std::string &p_file)
+{
+  std::ofstream file(p_file.c_str());
+  p_solver.WriteCheckpoint(file);
+  if (!file) {
+    std::cerr << "Error: Unable to write checkpoint file `" << p_file << "'.\n";
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  opterr = 0;
+  bool quiet = false, plus = false, verbose = false;
+  int iterations = 1000, interval = 0, threads = 0;
+  double tolerance = -1.0;
+  std::string checkpointFile, resumeFile;
+
+  int c;
+  while ((c = getopt(argc, argv, "c:d:e:hk:n:pqr:t:v")) != -1) {
+    switch (c) {
+    case 'c':
+      checkpointFile = optarg;
+      break;
+    case 'd':
+      g_numDecimals = atoi(optarg);
+      break;
+    case 'e':
+      tolerance = atof(optarg);
+      break;
+    case 'h':
+      PrintHelp(argv[0]);
+      break;
+    case 'k':
+      interval = atoi(optarg);
+      break;
+    case 'n':
+      iterations = atoi(optarg);
+      break;
+    case 'p':
+      plus = true;
+      break;
+    case 'q':
+      quiet = true;
+      break;
+    case 'r':
+      resumeFile = optarg;
+      break;
+    case 't':
+      threads = atoi(optarg);
+      break;
+    case 'v':
+      verbose = true;
+      break;
+    case '?':
+      if (isprint(optopt)) {
+	std::cerr << argv[0] << ": Unknown option `-" << ((char) optopt) << "'.\n";
+      }
+      else {
+	std::cerr << argv[0] << ": Unknown option character `\\x" << optopt << "`.\n";
+      }
+      return 1;
+    default:
+      abort();
+    }
+  }
+
+  if (!quiet) {
+    PrintBanner(std::cerr);
+  }
+
+  try {
+    Game game = ReadGame(std::cin);
+
+    if (!game->IsTree() || !game->IsPerfectRecall()) {
+      std::cerr << "Error: Game must be an extensive game with perfect recall.\n";
+      return 1;
+    }
+
+    EfgCfr solver(BehavSupport(game), plus, threads);
+
+    if (resumeFile != "") {
+      std::ifstream file(resumeFile.c_str());
+      if (!file) {
+	std::cerr << "Error: Unable to open checkpoint file `" << resumeFile << "'.\n";
+	return 1;
+      }
+      solver.ReadCheckpoint(file);
+    }
+
+    while (solver.NumIterations() < iterations) {
+      solver.Iterate();
+
+      if (verbose || tolerance >= 0.0) {
+	double exploitability = solver.GetExploitability();
+	if (verbose) {
+	  std::cout << "exploitability," << solver.NumIterations() << ",";
+	  std::cout << std::setprecision(g_numDecimals) << exploitability;
+	  std::cout << std::endl;
+	}
+	if (exploitability <= tolerance)  break;
+      }
+
+      if (checkpointFile != "" && interval > 0 &&
+	  solver.NumIterations() % interval == 0 &&
+	  !WriteCheckpoint(solver, checkpointFile)) {
+	return 1;
+      }
+    }
+
+    if (checkpointFile != "" && !WriteCheckpoint(solver, checkpointFile)) {
+      return 1;
+    }
+
+    PrintProfile(std::cout, "NE", solver.GetAverage());
+    return 0;
+  }
+  catch (InvalidFileException &e) {
+    std::cerr << "Error: " << e.what() << ".\n";
+    return 1;
+  }
+  catch (BadCheckpointException &e) {
+    std::cerr << "Error: " << e.what() << ".\n";
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Error: An internal error occurred.\n";
+    return 1;
+  }
+}
@@ -0,0 +1,547 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/cfr/efgcfr.cc
+// Counterfactual regret minimization for extensive games
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include "efgcfr.h"
+
+using namespace Gambit;
+
+//
+// The subtrees are walked in at most this many pieces, each with its
+// own record of changes to the regrets and strategy sums.  This does
+// not depend on the number of threads, so neither does the order in
+// which the changes are added up.
+//
+static const int c_maxPieces = 64;
+
+//========================================================================
+//                          class EfgCfr::Walker
+//========================================================================
+
+//
+// Walks subtrees under the current strategy, recording the changes to
+// the regrets and strategy sums.  The reach probabilities and values
+// at each depth are kept in buffers allocated once per walker.
+//
+class EfgCfr::Walker {
+public:
+  const EfgCfr &m_cfr;
+  int m_player;
+  double m_weight;
+  std::vector<double> m_regrets, m_strategySums;
+
+  Walker(const EfgCfr &p_cfr, int p_player, double p_weight);
+
+  /// Walks the subtree at the node, with the reach probabilities
+  /// of chance and each player given
+  void Walk(int p_node, const std::vector<double> &p_reach);
+
+private:
+  // Indexed by depth
+  std::vector<std::vector<double> > m_reach, m_values, m_actionValues;
+
+  void Walk(int p_node, int p_depth);
+};
+
+EfgCfr::Walker::Walker(const EfgCfr &p_cfr, int p_player, double p_weight)
+  : m_cfr(p_cfr), m_player(p_player), m_weight(p_weight),
+    m_regrets(p_cfr.m_regrets.size(), 0.0),
+    m_strategySums(p_cfr.m_regrets.size(), 0.0),
+    m_reach(p_cfr.m_maxDepth + 1,
+	    std::vector<double>(p_cfr.m_numPlayers + 1, 0.0)),
+    m_values(p_cfr.m_maxDepth + 1,
+	     std::vector<double>(p_cfr.m_numPlayers + 1, 0.0)),
+    m_actionValues(p_cfr.m_maxDepth + 1)
+{ }
+
+void EfgCfr::Walker::Walk(int p_node, const std::vector<double> &p_reach)
+{
+  m_reach[0] = p_reach;
+  Walk(p_node, 0);
+}
+
+//
+// Computes the values of the node to each player into m_values[depth],
+// with m_reach[depth] holding the probabilities of reaching it.
+//
+void EfgCfr::Walker::Walk(int p_node, int p_depth)
+{
+  const EfgCfr &cfr = m_cfr;
+  const std::vector<double> &reach = m_reach[p_depth];
+  std::vector<double> &value = m_values[p_depth];
+  std::fill(value.begin(), value.end(), 0.0);
+
+  int player = cfr.m_nodePlayer[p_node];
+  if (player >= 0) {
+    std::vector<double> &next = m_reach[p_depth + 1];
+    const std::vector<double> &childValue = m_values[p_depth + 1];
+    int first = cfr.m_firstChild[p_node];
+    int numChildren = cfr.m_numChildren[p_node];
+
+    if (player == 0) {
+      for (int k = 0; k < numChildren; k++) {
+	double prob = cfr.m_chanceProbs[first + k];
+	if (prob == 0.0)  continue;
+	next = reach;
+	next[0] *= prob;
+	Walk(cfr.m_children[first + k], p_depth + 1);
+	for (int pl = 1; pl <= cfr.m_numPlayers; pl++) {
+	  value[pl] += prob * childValue[pl];
+	}
+      }
+    }
+    else {
+      int infoset = cfr.m_nodeInfoset[p_node];
+      int action = cfr.m_firstAction[infoset];
+      std::vector<double> &actionValue = m_actionValues[p_depth];
+      actionValue.resize(numChildren);
+
+      for (int k = 0; k < numChildren; k++) {
+	double prob = cfr.m_strategy[action + k];
+	next = reach;
+	next[player] *= prob;
+	Walk(cfr.m_children[first + k], p_depth + 1);
+	actionValue[k] = childValue[player];
+	for (int pl = 1; pl <= cfr.m_numPlayers; pl++) {
+	  value[pl] += prob * childValue[pl];
+	}
+      }
+
+      if (m_player == 0 || m_player == player) {
+	// The probability that the others play to reach the node
+	double counterfactual = 1.0;
+	for (int pl = 0; pl <= cfr.m_numPlayers; pl++) {
+	  if (pl != player)  counterfactual *= reach[pl];
+	}
+	for (int k = 0; k < numChildren; k++) {
+	  m_regrets[action + k] +=
+	    counterfactual * (actionValue[k] - value[player]);
+	  m_strategySums[action + k] +=
+	    m_weight * reach[player] * cfr.m_strategy[action + k];
+	}
+      }
+    }
+  }
+
+  if (cfr.m_nodePayoffs[p_node] >= 0) {
+    const double *payoffs = &cfr.m_payoffs[cfr.m_nodePayoffs[p_node]];
+    for (int pl = 1; pl <= cfr.m_numPlayers; pl++) {
+      value[pl] += payoffs[pl - 1];
+    }
+  }
+}
+
+//========================================================================
+//                         class EfgCfr::WalkTask
+//========================================================================
+
+/// Walks a consecutive run of the children of the root
+class EfgCfr::WalkTask : public WorkTask {
+public:
+  Walker m_walker;
+  int m_first, m_last;
+
+  WalkTask(const EfgCfr &p_cfr, int p_player, double p_weight,
+	   int p_first, int p_last)
+    : m_walker(p_cfr, p_player, p_weight), m_first(p_first), m_last(p_last)
+  { }
+  void Run(void);
+};
+
+void EfgCfr::WalkTask::Run(void)
+{
+  const EfgCfr &cfr = m_walker.m_cfr;
+  std::vector<double> reach(cfr.m_numPlayers + 1, 1.0);
+  for (int k = m_first; k <= m_last; k++) {
+    reach[0] = cfr.m_chanceProbs[k];
+    if (reach[0] == 0.0)  continue;
+    m_walker.Walk(cfr.m_children[k], reach);
+  }
+}
+
+//========================================================================
+//                            class EfgCfr
+//========================================================================
+
+EfgCfr::EfgCfr(const BehavSupport &p_support, bool p_plus, int p_threads)
+  : m_support(p_support), m_plus(p_plus), m_pool(p_threads),
+    m_numPlayers(p_support.GetGame()->NumPlayers()), m_iterations(0),
+    m_maxDepth(0), m_numActions(0)
+{
+  Game game = m_support.GetGame();
+  m_infosetIndex = Array<Array<int> >(m_numPlayers);
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    m_infosetIndex[pl] = Array<int>(game->GetPlayer(pl)->NumInfosets());
+    for (int iset = 1; iset <= m_infosetIndex[pl].Length(); iset++) {
+      m_infosetIndex[pl][iset] = -1;
+    }
+  }
+
+  Flatten(game->GetRoot(), 0);
+
+  m_regrets = std::vector<double>(m_numActions, 0.0);
+  m_strategySums = std::vector<double>(m_numActions, 0.0);
+  m_strategy = std::vector<double>(m_numActions, 0.0);
+}
+
+EfgCfr::~EfgCfr()
+{ }
+
+int EfgCfr::Flatten(const GameNode &p_node, int p_depth)
+{
+  int index = m_nodePlayer.size();
+  if (p_depth > m_maxDepth)  m_maxDepth = p_depth;
+
+  m_nodePlayer.push_back(-1);
+  m_nodeInfoset.push_back(-1);
+  m_firstChild.push_back(0);
+  m_numChildren.push_back(0);
+  m_nodePayoffs.push_back(-1);
+
+  if (p_node->GetOutcome()) {
+    m_nodePayoffs[index] = m_payoffs.size();
+    for (int pl = 1; pl <= m_numPlayers; pl++) {
+      m_payoffs.push_back(p_node->GetOutcome()->GetPayoff<double>(pl));
+    }
+  }
+
+  GameInfoset infoset = p_node->GetInfoset();
+  if (!infoset)  return index;
+
+  std::vector<int> children;
+  std::vector<double> probs;
+  if (infoset->GetPlayer()->IsChance()) {
+    m_nodePlayer[index] = 0;
+    for (int i = 1; i <= p_node->NumChildren(); i++) {
+      probs.push_back(infoset->GetActionProb(i, (double) 0));
+      children.push_back(Flatten(p_node->GetChild(i), p_depth + 1));
+    }
+  }
+  else {
+    int pl = infoset->GetPlayer()->GetNumber();
+    int iset = infoset->GetNumber();
+    int numActions = m_support.NumActions(pl, iset);
+    if (m_infosetIndex[pl][iset] < 0) {
+      m_infosetIndex[pl][iset] = m_infosetPlayer.size();
+      m_infosetPlayer.push_back(pl);
+      m_infosetNumber.push_back(iset);
+      m_firstAction.push_back(m_numActions);
+      m_members.push_back(std::vector<int>());
+      m_numActions += numActions;
+    }
+    int k = m_infosetIndex[pl][iset];
+    m_nodePlayer[index] = pl;
+    m_nodeInfoset[index] = k;
+    m_members[k].push_back(index);
+    for (int act = 1; act <= numActions; act++) {
+      GameAction action = m_support.GetAction(pl, iset, act);
+      probs.push_back(0.0);
+      children.push_back(Flatten(p_node->GetChild(action->GetNumber()),
+				 p_depth + 1));
+    }
+  }
+
+  m_firstChild[index] = m_children.size();
+  m_numChildren[index] = children.size();
+  m_children.insert(m_children.end(), children.begin(), children.end());
+  m_chanceProbs.insert(m_chanceProbs.end(), probs.begin(), probs.end());
+  return index;
+}
+
+void EfgCfr::MatchRegrets(void)
+{
+  for (size_t k = 0; k < m_firstAction.size(); k++) {
+    int first = m_firstAction[k], numActions = NumActions(k);
+    double total = 0.0;
+    for (int a = first; a < first + numActions; a++) {
+      if (m_regrets[a] > 0.0)  total += m_regrets[a];
+    }
+    for (int a = first; a < first + numActions; a++) {
+      if (total > 0.0) {
+	m_strategy[a] = (m_regrets[a] > 0.0) ? m_regrets[a] / total : 0.0;
+      }
+      else {
+	m_strategy[a] = 1.0 / numActions;
+      }
+    }
+  }
+}
+
+void EfgCfr::Walk(int p_player)
+{
+  // CFR+ weights the strategy at iteration t by t
+  double weight = (m_plus) ? (double) m_iterations : 1.0;
+
+  std::vector<WalkTask *> tasks;
+  if (m_nodePlayer[0] == 0 && m_numChildren[0] > 1) {
+    int first = m_firstChild[0], numChildren = m_numChildren[0];
+    int pieces = std::min(numChildren, c_maxPieces);
+    for (int i = 0; i < pieces; i++) {
+      tasks.push_back(new WalkTask(*this, p_player, weight,
+				   first + i * numChildren / pieces,
+				   first + (i + 1) * numChildren / pieces - 1));
+    }
+  }
+
+  try {
+    if (tasks.empty()) {
+      WalkTask *task = new WalkTask(*this, p_player, weight, 0, -1);
+      tasks.push_back(task);
+      task->m_walker.Walk(0, std::vector<double>(m_numPlayers + 1, 1.0));
+    }
+    else {
+      WorkGroup group(m_pool);
+      for (size_t i = 0; i < tasks.size(); i++) {
+	group.Submit(tasks[i]);
+      }
+      group.Wait();
+    }
+  }
+  catch (...) {
+    for (size_t i = 0; i < tasks.size(); i++)  delete tasks[i];
+    throw;
+  }
+
+  for (size_t i = 0; i < tasks.size(); i++) {
+    const Walker &walker = tasks[i]->m_walker;
+    for (int a = 0; a < m_numActions; a++) {
+      m_regrets[a] += walker.m_regrets[a];
+      m_strategySums[a] += walker.m_strategySums[a];
+    }
+    delete tasks[i];
+  }
+
+  if (m_plus) {
+    for (int a = 0; a < m_numActions; a++) {
+      if (m_regrets[a] < 0.0)  m_regrets[a] = 0.0;
+    }
+  }
+}
+
+void EfgCfr::Iterate(void)
+{
+  m_iterations++;
+  if (m_plus) {
+    for (int pl = 1; pl <= m_numPlayers; pl++) {
+      MatchRegrets();
+      Walk(pl);
+    }
+  }
+  else {
+    MatchRegrets();
+    Walk(0);
+  }
+}
+
+std::vector<double> EfgCfr::AverageStrategy(void) const
+{
+  std::vector<double> strategy(m_numActions);
+  for (size_t k = 0; k < m_firstAction.size(); k++) {
+    int first = m_firstAction[k], numActions = NumActions(k);
+    double total = 0.0;
+    for (int a = first; a < first + numActions; a++) {
+      total += m_strategySums[a];
+    }
+    for (int a = first; a < first + numActions; a++) {
+      strategy[a] = (total > 0.0) ? m_strategySums[a] / total : 1.0 / numActions;
+    }
+  }
+  return strategy;
+}
+
+MixedBehavProfile<double> EfgCfr::GetAverage(void) const
+{
+  MixedBehavProfile<double> profile(m_support);
+  std::vector<double> strategy = AverageStrategy();
+  for (size_t k = 0; k < m_firstAction.size(); k++) {
+    for (int act = 1; act <= NumActions(k); act++) {
+      profile(m_infosetPlayer[k], m_infosetNumber[k], act) =
+	strategy[m_firstAction[k] + act - 1];
+    }
+  }
+  return profile;
+}
+
+//------------------------------------------------------------------------
+//                    EfgCfr: Computing exploitability
+//------------------------------------------------------------------------
+
+//
+// The best response of a player is found information set by information
+// set, memoizing the value of each node and the action chosen at each
+// information set.  The action at an information set maximizes the
+// value of its members, weighted by the probability the others play to
+// reach them; since the game has perfect recall, this only involves the
+// player's choices below it.
+//
+class EfgCfr::BestResponse {
+public:
+  BestResponse(const std::vector<int> &p_nodePlayer,
+	       int p_player, int p_numPlayers)
+    : m_player(p_player), m_numPlayers(p_numPlayers),
+      m_reach(p_nodePlayer.size(), 0.0), m_values(p_nodePlayer.size(), 0.0),
+      m_known(p_nodePlayer.size(), false)
+  { }
+
+  int m_player, m_numPlayers;
+  // Indexed by node
+  std::vector<double> m_reach, m_values;
+  std::vector<bool> m_known;
+  // Indexed by information set: the action chosen, or -1 if not yet known
+  std::vector<int> m_actions;
+};
+
+double EfgCfr::BestResponseValue(int p_player,
+				 const std::vector<double> &p_strategy) const
+{
+  BestResponse response(m_nodePlayer, p_player, m_numPlayers);
+  response.m_actions = std::vector<int>(m_firstAction.size(), -1);
+
+  // The nodes are in preorder, so every node follows its parent
+  response.m_reach[0] = 1.0;
+  for (size_t n = 0; n < m_nodePlayer.size(); n++) {
+    int player = m_nodePlayer[n];
+    if (player < 0)  continue;
+    for (int k = 0; k < m_numChildren[n]; k++) {
+      double prob = 1.0;
+      if (player == 0) {
+	prob = m_chanceProbs[m_firstChild[n] + k];
+      }
+      else if (player != p_player) {
+	prob = p_strategy[m_firstAction[m_nodeInfoset[n]] + k];
+      }
+      response.m_reach[m_children[m_firstChild[n] + k]] =
+	response.m_reach[n] * prob;
+    }
+  }
+
+  return NodeValue(response, p_strategy, 0);
+}
+
+double EfgCfr::NodeValue(BestResponse &p_response,
+			 const std::vector<double> &p_strategy,
+			 int p_node) const
+{
+  if (p_response.m_known[p_node])  return p_response.m_values[p_node];
+
+  double value = 0.0;
+  int player = m_nodePlayer[p_node];
+  int first = m_firstChild[p_node];
+  if (player == 0) {
+    for (int k = 0; k < m_numChildren[p_node]; k++) {
+      if (m_chanceProbs[first + k] > 0.0) {
+	value += (m_chanceProbs[first + k] *
+		  NodeValue(p_response, p_strategy, m_children[first + k]));
+      }
+    }
+  }
+  else if (player > 0 && player != p_response.m_player) {
+    int action = m_firstAction[m_nodeInfoset[p_node]];
+    for (int k = 0; k < m_numChildren[p_node]; k++) {
+      if (p_strategy[action + k] > 0.0) {
+	value += (p_strategy[action + k] *
+		  NodeValue(p_response, p_strategy, m_children[first + k]));
+      }
+    }
+  }
+  else if (player > 0) {
+    int infoset = m_nodeInfoset[p_node];
+    if (p_response.m_actions[infoset] < 0) {
+      const std::vector<int> &members = m_members[infoset];
+      double best = 0.0;
+      for (int k = 0; k < m_numChildren[p_node]; k++) {
+	double total = 0.0;
+	for (size_t i = 0; i < members.size(); i++) {
+	  int member = members[i];
+	  if (p_response.m_reach[member] > 0.0) {
+	    total += (p_response.m_reach[member] *
+		      NodeValue(p_response, p_strategy,
+				m_children[m_firstChild[member] + k]));
+	  }
+	}
+	if (k == 0 || total > best) {
+	  best = total;
+	  p_response.m_actions[infoset] = k;
+	}
+      }
+    }
+    value = NodeValue(p_response, p_strategy,
+		      m_children[first + p_response.m_actions[infoset]]);
+  }
+
+  if (m_nodePayoffs[p_node] >= 0) {
+    value += m_payoffs[m_nodePayoffs[p_node] + p_response.m_player - 1];
+  }
+  p_response.m_values[p_node] = value;
+  p_response.m_known[p_node] = true;
+  return value;
+}
+
+double EfgCfr::GetExploitability(void) const
+{
+  std::vector<double> strategy = AverageStrategy();
+  MixedBehavProfile<double> profile = GetAverage();
+  double exploitability = 0.0;
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    exploitability += (BestResponseValue(pl, strategy) -
+		       profile.GetPayoff(pl));
+  }
+  return exploitability;
+}
+
+//------------------------------------------------------------------------
+//                        EfgCfr: Checkpoints
+//------------------------------------------------------------------------
+
+void EfgCfr::WriteCheckpoint(std::ostream &p_stream) const
+{
+  p_stream << ((m_plus) ? "cfr+" : "cfr") << ' ';
+  p_stream << m_iterations << ' ' << m_numActions << std::endl;
+  p_stream << std::setprecision(17);
+  for (int a = 0; a < m_numActions; a++) {
+    p_stream << m_regrets[a] << ' ' << m_strategySums[a] << std::endl;
+  }
+}
+
+void EfgCfr::ReadCheckpoint(std::istream &p_stream)
+{
+  std::string variant;
+  int iterations, numActions;
+  if (!(p_stream >> variant >> iterations >> numActions) ||
+      variant != ((m_plus) ? "cfr+" : "cfr") ||
+      numActions != m_numActions || iterations < 0) {
+    throw BadCheckpointException();
+  }
+
+  std::vector<double> regrets(m_numActions), strategySums(m_numActions);
+  for (int a = 0; a < m_numActions; a++) {
+    if (!(p_stream >> regrets[a] >> strategySums[a])) {
+      throw BadCheckpointException();
+    }
+  }
+
+  m_iterations = iterations;
+  m_regrets = regrets;
+  m_strategySums = strategySums;
+}
@@ -0,0 +1,126 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/cfr/efgcfr.h
+// Counterfactual regret minimization for extensive games
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef EFGCFR_H
+#define EFGCFR_H
+
+#include <vector>
+#include "libgambit/libgambit.h"
+#include "libgambit/workpool.h"
+
+/// Exception thrown when a checkpoint cannot be read
+class BadCheckpointException : public Gambit::Exception {
+public:
+  virtual ~BadCheckpointException() throw() { }
+  const char *what(void) const throw()
+  { return "Checkpoint does not match the game and options"; }
+};
+
+//
+// Counterfactual regret minimization, in either its original form
+// or as CFR+.
+//
+// The tree is flattened into arrays when the solver is constructed, so
+// iterations do not touch the game objects.  Each iteration walks the
+// tree once, updating every player's regrets; CFR+ walks it once per
+// player, updating only that player's regrets, and weights the average
+// strategy by iteration.  When the root is a chance node, the subtrees
+// following each chance outcome are walked concurrently, each
+// accumulating its changes separately; these are then added up in
+// order, so the result does not depend on the number of threads.
+//
+// The games must have perfect recall.
+//
+class EfgCfr {
+public:
+  EfgCfr(const Gambit::BehavSupport &p_support, bool p_plus, int p_threads = 0);
+  ~EfgCfr();
+
+  /// Runs a single iteration
+  void Iterate(void);
+  /// Returns the number of iterations run so far
+  int NumIterations(void) const { return m_iterations; }
+
+  /// Returns the average of the strategies played so far
+  Gambit::MixedBehavProfile<double> GetAverage(void) const;
+  /// Returns the sum, over players, of the gain each player would get
+  /// by best responding to the average profile
+  double GetExploitability(void) const;
+
+  /// Writes the state of the solver, from which it can be resumed
+  void WriteCheckpoint(std::ostream &) const;
+  /// Restores a state written by WriteCheckpoint(); throws a
+  /// BadCheckpointException if it is from another game or variant
+  void ReadCheckpoint(std::istream &);
+
+private:
+  class Walker;
+  class WalkTask;
+  class BestResponse;
+
+  Gambit::BehavSupport m_support;
+  bool m_plus;
+  Gambit::WorkPool m_pool;
+  int m_numPlayers, m_iterations, m_maxDepth, m_numActions;
+
+  // The nodes, in preorder.  The player is zero for chance nodes and
+  // -1 for terminal nodes; the children of a node are found at
+  // m_children[m_firstChild[n]] onwards.
+  std::vector<int> m_nodePlayer, m_nodeInfoset, m_firstChild, m_numChildren;
+  std::vector<int> m_children;
+  // The probability of reaching each child of a chance node
+  std::vector<double> m_chanceProbs;
+  // The payoffs of the outcome at each node, or -1 if none
+  std::vector<int> m_nodePayoffs;
+  std::vector<double> m_payoffs;
+
+  // The information sets of the personal players, with the index of
+  // the first of their actions, and their members
+  std::vector<int> m_infosetPlayer, m_infosetNumber, m_firstAction;
+  std::vector<std::vector<int> > m_members;
+  // The index of each information set above, or -1 if unreachable
+  Gambit::Array<Gambit::Array<int> > m_infosetIndex;
+
+  // Indexed by action
+  std::vector<double> m_regrets, m_strategySums, m_strategy;
+
+  int NumActions(int p_infoset) const
+  { return m_numChildren[m_members[p_infoset][0]]; }
+
+  /// Appends the subtree to the arrays, returning the index of the node
+  int Flatten(const Gambit::GameNode &, int p_depth);
+  /// Sets the current strategy by regret matching
+  void MatchRegrets(void);
+  /// Walks the tree, updating the regrets of the player, or of every
+  /// player if zero
+  void Walk(int p_player);
+  /// Returns the probability of each action under the average profile
+  std::vector<double> AverageStrategy(void) const;
+  /// Returns the value to the player of best responding to the
+  /// strategy given
+  double BestResponseValue(int p_player,
+			   const std::vector<double> &p_strategy) const;
+  double NodeValue(BestResponse &, const std::vector<double> &p_strategy,
+		   int p_node) const;
+};
+
+#endif  // EFGCFR_H
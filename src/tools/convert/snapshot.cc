@@ -0,0 +1,117 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/convert/snapshot.cc
+// Convert games to and from binary snapshots
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <unistd.h>
+#include <cstdlib>
+#include <iostream>
+
+#include "libgambit/libgambit.h"
+
+void PrintBanner(std::ostream &p_stream)
+{
+  p_stream << "Convert a Gambit game to or from a binary snapshot\n";
+  p_stream << "Gambit version " VERSION ", Copyright (C) 1994-2010, The Gambit Project\n";
+  p_stream << "This is free software, distributed under the GNU GPL\n\n";
+}
+
+void PrintHelp(char *progname)
+{
+  PrintBanner(std::cerr);
+  std::cerr << "Usage: " << progname << " [OPTIONS]\n";
+  std::cerr << "Accepts game on standard input, as a savefile or a snapshot.\n";
+  std::cerr << "Writes the game to standard output as a binary snapshot,\n";
+  std::cerr << "which all Gambit tools accept in place of a savefile.\n";
+
+  std::cerr << "Options:\n";
+  std::cerr << "  -h               print this help message\n";
+  std::cerr << "  -q               quiet mode (suppresses banner)\n";
+  std::cerr << "  -s               for extensive games, include the reduced\n";
+  std::cerr << "                   strategic form in the snapshot\n";
+  std::cerr << "  -t               write the game as an .efg or .nfg savefile\n";
+  exit(1);
+}
+
+
+int main(int argc, char *argv[])
+{
+  int c;
+  bool quiet = false, strategies = false, text = false;
+
+  while ((c = getopt(argc, argv, "hqst")) != -1) {
+    switch (c) {
+    case 'q':
+      quiet = true;
+      break;
+    case 's':
+      strategies = true;
+      break;
+    case 't':
+      text = true;
+      break;
+    case 'h':
+      PrintHelp(argv[0]);
+      break;
+    case '?':
+      if (isprint(optopt)) {
+	std::cerr << argv[0] << ": Unknown option `-" << ((char) optopt) << "'.\n";
+      }
+      else {
+	std::cerr << argv[0] << ": Unknown option character `\\x" << optopt << "`.\n";
+      }
+      return 1;
+    default:
+      abort();
+    }
+  }
+
+  if (!quiet) {
+    PrintBanner(std::cerr);
+  }
+
+  try {
+    Gambit::Game game = Gambit::ReadGame(std::cin);
+
+    if (text) {
+      if (game->IsTree()) {
+	game->WriteEfgFile(std::cout);
+      }
+      else {
+	game->WriteNfgFile(std::cout);
+      }
+    }
+    else {
+      if (strategies && game->IsTree()) {
+	game->BuildComputedValues();
+      }
+      game->WriteSnapshotFile(std::cout);
+    }
+    return 0;
+  }
+  catch (Gambit::InvalidFileException &e) {
+    std::cerr << "Error: " << e.what() << ".\n";
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Error: An internal error occurred.\n";
+    return 1;
+  }
+}
@@ -391,8 +391,8 @@ int main(int argc, char *argv[])
     }
     return 0;
   }
-  catch (InvalidFileException) {
-    std::cerr << "Error: Game not in a recognized format.\n";
+  catch (InvalidFileException &e) {
+    std::cerr << "Error: " << e.what() << ".\n";
     return 1;
   }
   catch (...) {
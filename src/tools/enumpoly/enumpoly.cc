@@ -123,8 +123,8 @@ int main(int argc, char *argv[])
     }
     return 0;
   }
-  catch (Gambit::InvalidFileException) {
-    std::cerr << "Error: Game not in a recognized format.\n";
+  catch (Gambit::InvalidFileException &e) {
+    std::cerr << "Error: " << e.what() << ".\n";
     return 1;
   }
   catch (...) {
@@ -0,0 +1,415 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/enumpure/efgpure.cc
+// Enumerate pure-strategy equilibria of extensive games
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <cmath>
+#include "efgpure.h"
+
+using namespace Gambit;
+
+//
+// Each task searches a block of this many consecutive profiles, and
+// each call to Search() hands out this many blocks per thread.
+//
+static const long c_blockSize = 4096;
+static const int c_blocksPerThread = 4;
+
+//
+// A deviation found in floating point is taken to be a gain only if it
+// exceeds this, relative to the largest value a node can have.
+//
+static const double c_tolerance = 1.0e-9;
+
+//========================================================================
+//                       class EfgEnumPure::Checker
+//========================================================================
+
+//
+// Checks profiles for profitable deviations, with buffers for the
+// values and reach probabilities allocated once per checker.
+//
+class EfgEnumPure::Checker {
+public:
+  Checker(const EfgEnumPure &p_search);
+
+  /// Returns true if no player gains by deviating at an information set
+  bool IsNash(const std::vector<int> &p_digits);
+
+private:
+  const EfgEnumPure &m_search;
+  // The child chosen at each information set, and a copy for deviations
+  std::vector<int> m_actions, m_deviation;
+  std::vector<double> m_values, m_reach, m_deviationValues;
+  std::vector<Rational> m_exactValues, m_exactReach, m_exactDeviationValues;
+
+  /// Computes the value of each node to each player, when the
+  /// children given are chosen
+  template <class T>
+  void ComputeValues(const std::vector<int> &p_actions,
+		     const std::vector<T> &p_probs,
+		     const std::vector<T> &p_payoffs,
+		     std::vector<T> &p_values) const;
+  /// Returns true if some deviation from m_actions gains more than
+  /// the tolerance
+  template <class T>
+  bool HasGain(const std::vector<T> &p_probs,
+	       const std::vector<T> &p_payoffs, const T &p_tolerance,
+	       std::vector<T> &p_values, std::vector<T> &p_reach,
+	       std::vector<T> &p_deviationValues);
+};
+
+EfgEnumPure::Checker::Checker(const EfgEnumPure &p_search)
+  : m_search(p_search),
+    m_actions(p_search.m_choices.size()),
+    m_values(p_search.m_nodePlayer.size() * p_search.m_numPlayers),
+    m_reach(p_search.m_nodePlayer.size()),
+    m_deviationValues(m_values.size()),
+    m_exactValues(m_values.size()), m_exactReach(m_reach.size()),
+    m_exactDeviationValues(m_values.size())
+{ }
+
+template <class T>
+void EfgEnumPure::Checker::ComputeValues(const std::vector<int> &p_actions,
+					 const std::vector<T> &p_probs,
+					 const std::vector<T> &p_payoffs,
+					 std::vector<T> &p_values) const
+{
+  const EfgEnumPure &search = m_search;
+  int numPlayers = search.m_numPlayers;
+
+  for (int n = search.m_nodePlayer.size() - 1; n >= 0; n--) {
+    T *value = &p_values[n * numPlayers];
+    int payoffs = search.m_nodePayoffs[n];
+    for (int pl = 0; pl < numPlayers; pl++) {
+      value[pl] = (payoffs >= 0) ? p_payoffs[payoffs + pl] : T(0);
+    }
+
+    int first = search.m_firstChild[n];
+    if (search.m_nodePlayer[n] == 0) {
+      for (int k = first; k < first + search.m_numChildren[n]; k++) {
+	const T *childValue = &p_values[search.m_children[k] * numPlayers];
+	for (int pl = 0; pl < numPlayers; pl++) {
+	  value[pl] += p_probs[k] * childValue[pl];
+	}
+      }
+    }
+    else if (search.m_nodePlayer[n] > 0) {
+      int child = search.m_children[first +
+				    p_actions[search.m_nodeInfoset[n]]];
+      const T *childValue = &p_values[child * numPlayers];
+      for (int pl = 0; pl < numPlayers; pl++) {
+	value[pl] += childValue[pl];
+      }
+    }
+  }
+}
+
+template <class T>
+bool EfgEnumPure::Checker::HasGain(const std::vector<T> &p_probs,
+				   const std::vector<T> &p_payoffs,
+				   const T &p_tolerance,
+				   std::vector<T> &p_values,
+				   std::vector<T> &p_reach,
+				   std::vector<T> &p_deviationValues)
+{
+  const EfgEnumPure &search = m_search;
+  int numPlayers = search.m_numPlayers;
+  T zero(0);
+
+  ComputeValues(m_actions, p_probs, p_payoffs, p_values);
+
+  p_reach[0] = T(1);
+  for (size_t n = 0; n < search.m_nodePlayer.size(); n++) {
+    if (search.m_nodePlayer[n] < 0)  continue;
+    int first = search.m_firstChild[n];
+    int chosen = (search.m_nodePlayer[n] > 0) ?
+      first + m_actions[search.m_nodeInfoset[n]] : -1;
+    for (int k = first; k < first + search.m_numChildren[n]; k++) {
+      int child = search.m_children[k];
+      if (p_reach[n] == zero || (chosen >= 0 && k != chosen)) {
+	p_reach[child] = zero;
+      }
+      else if (chosen >= 0) {
+	p_reach[child] = p_reach[n];
+      }
+      else {
+	p_reach[child] = p_reach[n] * p_probs[k];
+      }
+    }
+  }
+
+  for (size_t i = 0; i < search.m_members.size(); i++) {
+    const std::vector<int> &members = search.m_members[i];
+    if (members.empty())  continue;
+    int pl = search.m_infosetPlayer[i] - 1, current = m_actions[i];
+
+    bool reached = false;
+    for (size_t m = 0; !reached && m < members.size(); m++) {
+      reached = (p_reach[members[m]] != zero);
+    }
+    if (!reached)  continue;
+
+    for (int act = 0; act < search.m_numChildren[members[0]]; act++) {
+      if (act == current)  continue;
+      T gain(0);
+
+      if (search.m_absentMinded[i]) {
+	m_deviation = m_actions;
+	m_deviation[i] = act;
+	ComputeValues(m_deviation, p_probs, p_payoffs, p_deviationValues);
+	gain = p_deviationValues[pl] - p_values[pl];
+      }
+      else {
+	for (size_t m = 0; m < members.size(); m++) {
+	  int node = members[m];
+	  if (p_reach[node] == zero)  continue;
+	  int first = search.m_firstChild[node];
+	  gain += p_reach[node] *
+	    (p_values[search.m_children[first + act] * numPlayers + pl] -
+	     p_values[search.m_children[first + current] * numPlayers + pl]);
+	}
+      }
+
+      if (gain > p_tolerance)  return true;
+    }
+  }
+
+  return false;
+}
+
+bool EfgEnumPure::Checker::IsNash(const std::vector<int> &p_digits)
+{
+  for (size_t i = 0; i < m_actions.size(); i++) {
+    m_actions[i] = m_search.m_choices[i][p_digits[i]];
+  }
+
+  if (HasGain(m_search.m_probs, m_search.m_payoffs, m_search.m_tolerance,
+	      m_values, m_reach, m_deviationValues)) {
+    return false;
+  }
+  return !HasGain(m_search.m_exactProbs, m_search.m_exactPayoffs,
+		  Rational(0), m_exactValues, m_exactReach,
+		  m_exactDeviationValues);
+}
+
+//========================================================================
+//                      class EfgEnumPure::SearchTask
+//========================================================================
+
+/// Searches a block of consecutive profiles
+class EfgEnumPure::SearchTask : public WorkTask {
+public:
+  const EfgEnumPure &m_search;
+  std::vector<int> m_first;
+  long m_count;
+  std::vector<std::vector<int> > m_found;
+
+  SearchTask(const EfgEnumPure &p_search, const std::vector<int> &p_first)
+    : m_search(p_search), m_first(p_first), m_count(0) { }
+  void Run(void);
+};
+
+void EfgEnumPure::SearchTask::Run(void)
+{
+  Checker checker(m_search);
+  std::vector<int> digits(m_first);
+  for (long i = 0; i < m_count; i++) {
+    if (checker.IsNash(digits))  m_found.push_back(digits);
+    m_search.Advance(digits);
+  }
+}
+
+//========================================================================
+//                          class EfgEnumPure
+//========================================================================
+
+EfgEnumPure::EfgEnumPure(const BehavSupport &p_support, int p_threads)
+  : m_support(p_support), m_pool(p_threads),
+    m_numPlayers(p_support.GetGame()->NumPlayers()), m_atEnd(false)
+{
+  Game game = m_support.GetGame();
+  for (int pl = 1; pl <= m_numPlayers; pl++) {
+    GamePlayer player = game->GetPlayer(pl);
+    m_firstInfoset.push_back(m_infosetPlayer.size());
+    for (int iset = 1; iset <= player->NumInfosets(); iset++) {
+      GameInfoset infoset = player->GetInfoset(iset);
+      m_infosetPlayer.push_back(pl);
+      m_infosetNumber.push_back(iset);
+      m_members.push_back(std::vector<int>());
+      m_absentMinded.push_back(0);
+
+      // As in BehavIterator, information sets the support cannot reach
+      // stay at the first action of the game
+      std::vector<int> choices;
+      if (m_support.MayReach(infoset)) {
+	for (int act = 1; act <= m_support.NumActions(pl, iset); act++) {
+	  choices.push_back(m_support.GetAction(pl, iset, act)->GetNumber() - 1);
+	}
+      }
+      else {
+	choices.push_back(0);
+      }
+      m_choices.push_back(choices);
+    }
+  }
+
+  std::vector<int> onPath(m_members.size(), 0);
+  Flatten(game->GetRoot(), onPath);
+
+  // The largest total absolute payoff along any path from a node bounds
+  // the values computed, and so the rounding errors in them
+  std::vector<double> bound(m_nodePlayer.size(), 0.0);
+  for (int n = m_nodePlayer.size() - 1; n >= 0; n--) {
+    double below = 0.0;
+    for (int k = m_firstChild[n]; k < m_firstChild[n] + m_numChildren[n]; k++) {
+      if (bound[m_children[k]] > below)  below = bound[m_children[k]];
+    }
+    double payoff = 0.0;
+    if (m_nodePayoffs[n] >= 0) {
+      for (int pl = 0; pl < m_numPlayers; pl++) {
+	if (fabs(m_payoffs[m_nodePayoffs[n] + pl]) > payoff) {
+	  payoff = fabs(m_payoffs[m_nodePayoffs[n] + pl]);
+	}
+      }
+    }
+    bound[n] = payoff + below;
+  }
+  m_tolerance = c_tolerance * (1.0 + bound[0]);
+
+  m_next = std::vector<int>(m_choices.size(), 0);
+}
+
+EfgEnumPure::~EfgEnumPure()
+{ }
+
+int EfgEnumPure::Flatten(const GameNode &p_node, std::vector<int> &p_onPath)
+{
+  int index = m_nodePlayer.size();
+
+  m_nodePlayer.push_back(-1);
+  m_nodeInfoset.push_back(-1);
+  m_firstChild.push_back(0);
+  m_numChildren.push_back(0);
+  m_nodePayoffs.push_back(-1);
+
+  if (p_node->GetOutcome()) {
+    m_nodePayoffs[index] = m_payoffs.size();
+    for (int pl = 1; pl <= m_numPlayers; pl++) {
+      m_payoffs.push_back(p_node->GetOutcome()->GetPayoff<double>(pl));
+      m_exactPayoffs.push_back(p_node->GetOutcome()->GetPayoff<Rational>(pl));
+    }
+  }
+
+  GameInfoset infoset = p_node->GetInfoset();
+  if (!infoset)  return index;
+
+  int k = -1;
+  if (infoset->GetPlayer()->IsChance()) {
+    m_nodePlayer[index] = 0;
+  }
+  else {
+    int pl = infoset->GetPlayer()->GetNumber();
+    k = m_firstInfoset[pl - 1] + infoset->GetNumber() - 1;
+    m_nodePlayer[index] = pl;
+    m_nodeInfoset[index] = k;
+    m_members[k].push_back(index);
+    if (p_onPath[k]++ > 0)  m_absentMinded[k] = 1;
+  }
+
+  std::vector<int> children;
+  std::vector<double> probs;
+  std::vector<Rational> exactProbs;
+  for (int i = 1; i <= p_node->NumChildren(); i++) {
+    if (k < 0) {
+      probs.push_back(infoset->GetActionProb(i, (double) 0));
+      exactProbs.push_back(infoset->GetActionProb(i, Rational(0)));
+    }
+    else {
+      probs.push_back(0.0);
+      exactProbs.push_back(Rational(0));
+    }
+    children.push_back(Flatten(p_node->GetChild(i), p_onPath));
+  }
+  if (k >= 0)  p_onPath[k]--;
+
+  m_firstChild[index] = m_children.size();
+  m_numChildren[index] = children.size();
+  m_children.insert(m_children.end(), children.begin(), children.end());
+  m_probs.insert(m_probs.end(), probs.begin(), probs.end());
+  m_exactProbs.insert(m_exactProbs.end(), exactProbs.begin(), exactProbs.end());
+  return index;
+}
+
+bool EfgEnumPure::Advance(std::vector<int> &p_digits) const
+{
+  for (int i = p_digits.size() - 1; i >= 0; i--) {
+    if (++p_digits[i] < (int) m_choices[i].size())  return true;
+    p_digits[i] = 0;
+  }
+  return false;
+}
+
+bool EfgEnumPure::Search(List<MixedBehavProfile<Rational> > &p_solutions)
+{
+  if (m_atEnd)  return false;
+
+  std::vector<SearchTask *> tasks;
+  int numBlocks = c_blocksPerThread * m_pool.NumThreads();
+  for (int b = 0; !m_atEnd && b < numBlocks; b++) {
+    SearchTask *task = new SearchTask(*this, m_next);
+    tasks.push_back(task);
+    while (!m_atEnd && task->m_count < c_blockSize) {
+      task->m_count++;
+      m_atEnd = !Advance(m_next);
+    }
+  }
+
+  try {
+    WorkGroup group(m_pool);
+    for (size_t i = 0; i < tasks.size(); i++) {
+      group.Submit(tasks[i]);
+    }
+    group.Wait();
+  }
+  catch (...) {
+    for (size_t i = 0; i < tasks.size(); i++)  delete tasks[i];
+    throw;
+  }
+
+  Game game = m_support.GetGame();
+  for (size_t i = 0; i < tasks.size(); i++) {
+    for (size_t j = 0; j < tasks[i]->m_found.size(); j++) {
+      const std::vector<int> &digits = tasks[i]->m_found[j];
+      MixedBehavProfile<Rational> profile(game);
+      // zero out all the entries, since any equilibria are pure
+      ((Vector<Rational> &) profile).operator=(Rational(0));
+      for (size_t k = 0; k < digits.size(); k++) {
+	GameInfoset infoset =
+	  game->GetPlayer(m_infosetPlayer[k])->GetInfoset(m_infosetNumber[k]);
+	profile(infoset->GetAction(m_choices[k][digits[k]] + 1)) = 1;
+      }
+      p_solutions.Append(profile);
+    }
+    delete tasks[i];
+  }
+
+  return !m_atEnd;
+}
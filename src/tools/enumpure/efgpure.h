@@ -0,0 +1,102 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/enumpure/efgpure.h
+// Enumerate pure-strategy equilibria of extensive games
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#ifndef EFGPURE_H
+#define EFGPURE_H
+
+#include <vector>
+#include "libgambit/libgambit.h"
+#include "libgambit/workpool.h"
+
+//
+// Searches the pure behavior profiles of a support for Nash equilibria,
+// in the order of BehavIterator.
+//
+// The tree is flattened into arrays when the search is constructed, so
+// the profiles can be checked without touching the game objects.  For
+// each profile, one pass up the tree computes the value of every node
+// and one pass down computes the probability each node is reached;
+// the gain from deviating to an action is then found by adding up,
+// over the members of the information set, the reach probability times
+// the difference in value of the two children.  This is done first in
+// floating point, and only the profiles which no deviation improves
+// upon by more than a tolerance are checked again exactly.  Information
+// sets with absent-minded members are instead checked by evaluating
+// the deviation from the root.
+//
+// The profiles are searched in blocks, which are checked concurrently;
+// the equilibria are reported in the same order whatever the number
+// of threads.
+//
+class EfgEnumPure {
+public:
+  EfgEnumPure(const Gambit::BehavSupport &p_support, int p_threads = 1);
+  ~EfgEnumPure();
+
+  /// Searches the next batch of profiles, appending the equilibria
+  /// found; returns false once every profile has been searched
+  bool Search(Gambit::List<Gambit::MixedBehavProfile<Gambit::Rational> > &);
+
+private:
+  class Checker;
+  class SearchTask;
+
+  Gambit::BehavSupport m_support;
+  Gambit::WorkPool m_pool;
+  int m_numPlayers;
+  double m_tolerance;
+
+  // The nodes, in preorder.  The player is zero for chance nodes and
+  // -1 for terminal nodes; the children of a node are found at
+  // m_children[m_firstChild[n]] onwards, one for each action.
+  std::vector<int> m_nodePlayer, m_nodeInfoset, m_firstChild, m_numChildren;
+  std::vector<int> m_children;
+  // The probability of each child of a chance node, and zero otherwise
+  std::vector<double> m_probs;
+  std::vector<Gambit::Rational> m_exactProbs;
+  // The payoffs of the outcome at each node, or -1 if none
+  std::vector<int> m_nodePayoffs;
+  std::vector<double> m_payoffs;
+  std::vector<Gambit::Rational> m_exactPayoffs;
+
+  // The information sets of the personal players, in the order of
+  // BehavIterator, with their members and the actions in the support.
+  // Only the information sets the support may reach have more than
+  // one choice.  The information sets of each player start at the
+  // index in m_firstInfoset.
+  std::vector<int> m_infosetPlayer, m_infosetNumber, m_firstInfoset;
+  std::vector<std::vector<int> > m_members, m_choices;
+  std::vector<char> m_absentMinded;
+
+  // The first profile not yet searched
+  std::vector<int> m_next;
+  bool m_atEnd;
+
+  /// Appends the subtree to the arrays, returning the index of the
+  /// node.  The count of each information set's members on the path
+  /// to the node is used to find absent-mindedness.
+  int Flatten(const Gambit::GameNode &, std::vector<int> &p_onPath);
+  /// Moves the profile on to the next, returning false after the last
+  bool Advance(std::vector<int> &p_digits) const;
+};
+
+#endif  // EFGPURE_H
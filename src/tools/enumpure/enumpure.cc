@@ -25,9 +25,12 @@
 #include <iostream>
 #include "libgambit/libgambit.h"
 #include "libgambit/subgame.h"
+#include "efgpure.h"
 
 using namespace Gambit;
 
+int g_numThreads = 1;
+
 template <class T>
 void PrintProfile(std::ostream &p_stream,
 		  const MixedBehavProfile<T> &p_profile)
@@ -47,46 +50,18 @@ List<MixedBehavProfile<Rational> > SolveBehav(const BehavSupport &p_support,
 					      bool p_print = false)
 {
   List<MixedBehavProfile<Rational> > solutions;
-
-  Game efg = p_support.GetGame();
-
-  for (BehavIterator citer(p_support); !citer.AtEnd(); citer++) {
-    bool isNash = true;
-
-    for (GamePlayerIterator player = efg->Players(); 
-	 isNash && !player.AtEnd(); player++)  {
-      Rational current = citer->GetPayoff<Rational>(player);
-	
-      for (int iset = 1; isNash && iset <= player->NumInfosets(); iset++) {
-	GameInfoset infoset = player->GetInfoset(iset);
-	for (int act = 1; act <= infoset->NumActions(); act++) {
-	  GameAction action = infoset->GetAction(act);
-	  if (citer->GetActionValue<Rational>(action) > current)  {
-	    isNash = false;
-	    break;
-	  }
-	}
+  EfgEnumPure search(p_support, g_numThreads);
+
+  bool more;
+  do {
+    int found = solutions.Length();
+    more = search.Search(solutions);
+    if (p_print) {
+      for (int i = found + 1; i <= solutions.Length(); i++) {
+	PrintProfile(std::cout, solutions[i]);
       }
     }
-      
-    if (isNash)  {
-      MixedBehavProfile<Rational> temp(efg);
-      // zero out all the entries, since any equilibria are pure
-      ((Vector<Rational> &) temp).operator=(Rational(0));
-
-      for (GamePlayerIterator player = efg->Players();
-	   !player.AtEnd(); player++) {
-	for (int iset = 1; iset <= player->NumInfosets(); iset++) {
-	  temp(citer->GetAction(player->GetInfoset(iset))) = 1;
-	}
-      }
-
-      if (p_print) {
-	PrintProfile(std::cout, temp);
-      }
-      solutions.Append(temp);
-    }
-  }
+  } while (more);
 
   return solutions;
 }
@@ -114,16 +89,13 @@ void PrintProfile(std::ostream &p_stream,
 
 void SolveMixed(Game p_nfg)
 {
-  for (StrategyIterator citer(p_nfg); !citer.AtEnd(); citer++) {
+  for (ContingencyIterator citer(p_nfg); !citer.AtEnd(); citer++) {
     bool flag = true;
 
-    for (GamePlayerIterator player = p_nfg->Players(); 
-	 flag && !player.AtEnd(); player++)  {
-      Rational current = (*citer)->GetPayoff(player);
-      PureStrategyProfile p = (*citer)->Copy(); 
-      for (GameStrategyIterator strategy = player->Strategies();
-	   !strategy.AtEnd(); strategy++) {
-	if (p->GetStrategyValue(strategy) > current)  {
+    for (int pl = 1; flag && pl <= p_nfg->NumPlayers(); pl++) {
+      Rational current = citer.GetPayoff<Rational>(pl);
+      for (int st = 1; st <= p_nfg->GetPlayer(pl)->NumStrategies(); st++) {
+	if (citer.GetStrategyValue<Rational>(pl, st) > current)  {
 	  flag = false;
 	  break;
 	}
@@ -133,10 +105,8 @@ void SolveMixed(Game p_nfg)
     if (flag)  {
       MixedStrategyProfile<Rational> temp(p_nfg->NewMixedStrategyProfile(Rational(0)));
       ((Vector<Rational> &) temp).operator=(Rational(0));
-      PureStrategyProfile profile = (*citer)->Copy();
-      for (GamePlayerIterator player = p_nfg->Players();
-	   !player.AtEnd(); player++) {
-	temp[profile->GetStrategy(player)] = 1;
+      for (int pl = 1; pl <= p_nfg->NumPlayers(); pl++) {
+	temp[citer.GetStrategy(pl)] = 1;
       }
       
       PrintProfile(std::cout, temp);
@@ -164,6 +134,7 @@ void PrintHelp(char *progname)
   std::cerr << "  -P               find only subgame-perfect equilibria\n";
   std::cerr << "  -h               print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
+  std::cerr << "  -t THREADS       number of threads (default 1; 0 for one per processor)\n";
   exit(1);
 }
 
@@ -174,7 +145,7 @@ int main(int argc, char *argv[])
   bool quiet = false, useStrategic = false, bySubgames = false;
 
   int c;
-  while ((c = getopt(argc, argv, "hqSP")) != -1) {
+  while ((c = getopt(argc, argv, "hqSPt:")) != -1) {
     switch (c) {
     case 'S':
       useStrategic = true;
@@ -188,6 +159,9 @@ int main(int argc, char *argv[])
     case 'q':
       quiet = true;
       break;
+    case 't':
+      g_numThreads = atoi(optarg);
+      break;
     case '?':
       if (isprint(optopt)) {
 	std::cerr << argv[0] << ": Unknown option `-" << ((char) optopt) << "'.\n";
@@ -227,8 +201,8 @@ int main(int argc, char *argv[])
     }
     return 0;
   }
-  catch (InvalidFileException) {
-    std::cerr << "Error: Game not in a recognized format.\n";
+  catch (InvalidFileException &e) {
+    std::cerr << "Error: " << e.what() << ".\n";
     return 1;
   }
   catch (...) {
@@ -0,0 +1,221 @@
+//
+// This file is part of Gambit
+// Copyright (c) 1994-2010, The Gambit Project (http://www.gambit-project.org)
+//
+// FILE: src/tools/exploit/exploit.cc
+// Compute the exploitability of profiles
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111-1307, USA.
+//
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <unistd.h>
+#include "libgambit/libgambit.h"
+
+using namespace Gambit;
+
+int g_numDecimals = 6;
+bool g_verbose = false;
+int g_numThreads = 1;
+
+void PrintBanner(std::ostream &p_stream)
+{
+  p_stream << "Compute the exploitability of profiles\n";
+  p_stream << "Gambit version " VERSION ", Copyright (C) 1994-2010, The Gambit Project\n";
+  p_stream << "This is free software, distributed under the GNU GPL\n\n";
+}
+
+void PrintHelp(char *progname)
+{
+  PrintBanner(std::cerr);
+  std::cerr << "Usage: " << progname << " [OPTIONS] FILE\n";
+  std::cerr << "Accepts game on standard input, and profiles in FILE.\n";
+
+  std::cerr << "Options:\n";
+  std::cerr << "  -d DECIMALS      compute using floating-point arithmetic;\n";
+  std::cerr << "                   display results with DECIMALS digits\n";
+  std::cerr << "  -h               print this help message\n";
+  std::cerr << "  -q               quiet mode (suppresses banner)\n";
+  std::cerr << "  -S               profiles are mixed strategy profiles\n";
+  std::cerr << "  -t THREADS       number of threads (default 1; 0 for one per processor)\n";
+  std::cerr << "  -v               also print the value of each player's best response\n";
+  exit(1);
+}
+
+//
+// Reads a profile from a line of comma-separated probabilities, which
+// may be fractions or decimals.  A leading tag, such as the "NE" which
+// solvers print, is skipped.  Blank lines are skipped; returns false at
+// the end of the file.
+//
+bool ReadProfile(std::istream &p_stream, Array<std::string> &p_values)
+{
+  std::string line;
+  while (std::getline(p_stream, line)) {
+    if (line.find_first_not_of(" \t\r") == std::string::npos)  continue;
+
+    p_values = Array<std::string>();
+    std::string::size_type start = 0;
+    while (true) {
+      std::string::size_type end = line.find(',', start);
+      std::string value = line.substr(start, end - start);
+      if (start > 0 || value.find_first_of("0123456789") != std::string::npos) {
+	p_values.Append(value);
+      }
+      if (end == std::string::npos)  break;
+      start = end + 1;
+    }
+    return true;
+  }
+  return false;
+}
+
+void PrintValue(std::ostream &p_stream, double p_value)
+{
+  p_stream.setf(std::ios::fixed);
+  p_stream << std::setprecision(g_numDecimals) << p_value;
+}
+
+void PrintValue(std::ostream &p_stream, const Rational &p_value)
+{
+  p_stream << p_value;
+}
+
+template <class T, class Profile>
+void PrintExploitability(std::ostream &p_stream, const Profile &p_profile)
+{
+  if (g_verbose) {
+    Vector<T> values = p_profile.GetBestResponseValues(g_numThreads);
+    p_stream << "bestresponse";
+    for (int pl = 1; pl <= values.Length(); pl++) {
+      p_stream << ",";
+      PrintValue(p_stream, values[pl]);
+    }
+    p_stream << std::endl;
+  }
+  p_stream << "exploitability,";
+  PrintValue(p_stream, p_profile.GetExploitability(g_numThreads));
+  p_stream << std::endl;
+}
+
+template <class T>
+bool Evaluate(const Game &p_game, std::istream &p_profiles, bool p_strategic)
+{
+  Array<std::string> values;
+  for (int count = 1; ReadProfile(p_profiles, values); count++) {
+    int length = ((p_strategic) ?
+		  p_game->NewMixedStrategyProfile((T) 0).MixedProfileLength() :
+		  MixedBehavProfile<T>(p_game).Length());
+    if (values.Length() != length) {
+      std::cerr << "Error: Profile " << count << " has " << values.Length();
+      std::cerr << " probabilities; the game requires " << length << ".\n";
+      return false;
+    }
+
+    if (p_strategic) {
+      MixedStrategyProfile<T> profile(p_game->NewMixedStrategyProfile((T) 0));
+      for (int i = 1; i <= length; i++) {
+	profile[i] = (T) lexical_cast<Rational>(values[i]);
+      }
+      PrintExploitability<T>(std::cout, profile);
+    }
+    else {
+      MixedBehavProfile<T> profile(p_game);
+      for (int i = 1; i <= length; i++) {
+	profile[i] = (T) lexical_cast<Rational>(values[i]);
+      }
+      PrintExploitability<T>(std::cout, profile);
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[])
+{
+  opterr = 0;
+  bool quiet = false, useFloat = false, useStrategic = false;
+
+  int c;
+  while ((c = getopt(argc, argv, "d:hqSt:v")) != -1) {
+    switch (c) {
+    case 'd':
+      useFloat = true;
+      g_numDecimals = atoi(optarg);
+      break;
+    case 'h':
+      PrintHelp(argv[0]);
+      break;
+    case 'q':
+      quiet = true;
+      break;
+    case 'S':
+      useStrategic = true;
+      break;
+    case 't':
+      g_numThreads = atoi(optarg);
+      break;
+    case 'v':
+      g_verbose = true;
+      break;
+    case '?':
+      if (isprint(optopt)) {
+	std::cerr << argv[0] << ": Unknown option `-" << ((char) optopt) << "'.\n";
+      }
+      else {
+	std::cerr << argv[0] << ": Unknown option character `\\x" << optopt << "`.\n";
+      }
+      return 1;
+    default:
+      abort();
+    }
+  }
+
+  if (optind != argc - 1) {
+    PrintHelp(argv[0]);
+  }
+
+  if (!quiet) {
+    PrintBanner(std::cerr);
+  }
+
+  std::ifstream profiles(argv[optind]);
+  if (!profiles) {
+    std::cerr << "Error: Unable to open profile file `" << argv[optind] << "'.\n";
+    return 1;
+  }
+
+  try {
+    Game game = ReadGame(std::cin);
+    bool strategic = !game->IsTree() || useStrategic;
+    if (strategic) {
+      game->BuildComputedValues();
+    }
+
+    bool ok = ((useFloat) ? Evaluate<double>(game, profiles, strategic) :
+	       Evaluate<Rational>(game, profiles, strategic));
+    return (ok) ? 0 : 1;
+  }
+  catch (InvalidFileException &e) {
+    std::cerr << "Error: " << e.what() << ".\n";
+    return 1;
+  }
+  catch (...) {
+    std::cerr << "Error: An internal error occurred.\n";
+    return 1;
+  }
+}
@@ -111,14 +111,14 @@ void Solve(const Gambit::Game &p_game)
   gnmgame *A = new nfgame(p_game->NumPlayers(), actions, payoffs);
   
   int *profile = new int[p_game->NumPlayers()];
-  for (Gambit::StrategyIterator iter(p_game); !iter.AtEnd(); iter++) {
+  for (Gambit::ContingencyIterator iter(p_game); !iter.AtEnd(); iter++) {
     for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-      profile[pl-1] = (*iter)->GetStrategy(pl)->GetNumber() - 1;
+      profile[pl-1] = iter.GetStrategyIndex(pl) - 1;
     }
 
     for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
       A->setPurePayoff(pl-1, profile, 
-		       (double) ((*iter)->GetPayoff(pl) - minPay) *
+		       (double) (iter.GetPayoff<Gambit::Rational>(pl) - minPay) *
 		       scale);
     }
   }
@@ -223,8 +223,8 @@ int main(int argc, char *argv[])
     Solve(game);
     return 0;
   }
-  catch (Gambit::InvalidFileException) {
-    std::cerr << "Error: Game not in a recognized format.\n";
+  catch (Gambit::InvalidFileException &e) {
+    std::cerr << "Error: " << e.what() << ".\n";
     return 1;
   }
   catch (...) {
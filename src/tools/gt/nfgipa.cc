@@ -81,13 +81,13 @@ void Solve(const Gambit::Game &p_game, const Gambit::Array<double> &p_pert)
   gnmgame *A = new nfgame(p_game->NumPlayers(), actions, payoffs);
   
   int *profile = new int[p_game->NumPlayers()];
-  for (Gambit::StrategyIterator iter(p_game); !iter.AtEnd(); iter++) {
+  for (Gambit::ContingencyIterator iter(p_game); !iter.AtEnd(); iter++) {
     for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-      profile[pl-1] = (*iter)->GetStrategy(pl)->GetNumber() - 1;
+      profile[pl-1] = iter.GetStrategyIndex(pl) - 1;
     }
 
     for (int pl = 1; pl <= p_game->NumPlayers(); pl++) {
-      A->setPurePayoff(pl-1, profile, (*iter)->GetPayoff(pl));
+      A->setPurePayoff(pl-1, profile, iter.GetPayoff<double>(pl));
     }
   }
 
@@ -160,8 +160,8 @@ int main(int argc, char *argv[])
     Solve(game, pert);
     return 0;
   }
-  catch (Gambit::InvalidFileException) {
-    std::cerr << "Error: Game not in a recognized format.\n";
+  catch (Gambit::InvalidFileException &e) {
+    std::cerr << "Error: " << e.what() << ".\n";
     return 1;
   }
   catch (...) {
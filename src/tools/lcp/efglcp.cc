@@ -28,6 +28,7 @@
 
 using namespace Gambit;
 
+#include "liblinear/sparsematrix.h"
 #include "lhtab.h"
 #include "lemketab.h"
 
@@ -159,9 +160,14 @@ private:
   T maxpay,eps;
   List<BFS<T> > m_list;
   List<GameInfoset> isets1, isets2;
-
-  void FillTableau(const BehavSupport &, Matrix<T> &, const GameNode &, T,
-		   int, int, int, int);
+  // For each player and infoset, the position of the infoset among the
+  // reachable ones, and the sequence preceding its first action;
+  // zero for unreachable infosets
+  Array<Array<int> > m_infosetIndex, m_sequenceOffset;
+
+  void IndexSequences(const BehavSupport &);
+  void FillTableau(const BehavSupport &, SparseMatrix<T> &,
+		   const GameNode &, T, int, int);
   int AddBFS(const LTableau<T> &tab);
   int AllLemke(const BehavSupport &, int dup, LTableau<T> &B,
 	       int depth, Matrix<T> &,
@@ -227,7 +233,7 @@ template <class T> List<MixedBehavProfile<T> >
 SolveEfgLcp<T>::Solve(const BehavSupport &p_support, bool p_print /*= true*/)
 {
   BFS<T> cbfs;
-  int i, j;
+  int i;
 
   isets1 = p_support.ReachableInfosets(p_support.GetGame()->GetPlayer(1));
   isets2 = p_support.ReachableInfosets(p_support.GetGame()->GetPlayer(2));
@@ -242,30 +248,30 @@ SolveEfgLcp<T>::Solve(const BehavSupport &p_support, bool p_print /*= true*/)
 
   ntot = ns1+ns2+ni1+ni2;
 
-  Matrix<T> A(1,ntot,0,ntot);
+  SparseMatrix<T> S(1,ntot,0,ntot);
   Vector<T> b(1,ntot);
 
   maxpay = p_support.GetGame()->GetMaxPayoff() + Rational(1);
 
   T prob = (T)1;
-  for (i = A.MinRow(); i <= A.MaxRow(); i++) {
-    b[i] = (T) 0;
-    for (j = A.MinCol(); j <= A.MaxCol(); j++) {
-      A(i,j) = (T) 0; 
-    }
-  }
+  b = (T) 0;
 
-  FillTableau(p_support, A, p_support.GetGame()->GetRoot(), prob, 1, 1, 0, 0);
-  for (i = A.MinRow(); i <= A.MaxRow(); i++) { 
-    A(i,0) = -(T) 1;
+  IndexSequences(p_support);
+  FillTableau(p_support, S, p_support.GetGame()->GetRoot(), prob, 1, 1);
+  for (i = S.MinRow(); i <= S.MaxRow(); i++) { 
+    S.Set(i,0,-(T) 1);
   }
-  A(1,ns1+ns2+1) = (T)1;
-  A(ns1+ns2+1,1) = -(T)1;
-  A(ns1+1,ns1+ns2+ni1+1) = (T)1;
-  A(ns1+ns2+ni1+1,ns1+1) = -(T)1;
+  S.Set(1,ns1+ns2+1,(T)1);
+  S.Set(ns1+ns2+1,1,-(T)1);
+  S.Set(ns1+1,ns1+ns2+ni1+1,(T)1);
+  S.Set(ns1+ns2+ni1+1,ns1+1,-(T)1);
   b[ns1+ns2+1] = -(T)1;
   b[ns1+ns2+ni1+1] = -(T)1;
 
+  // The tableau itself is still dense
+  Matrix<T> A(1,ntot,0,ntot);
+  S.GetDense(A);
+
   LTableau<T> tab(A,b);
   eps = tab.Epsilon();
   
@@ -398,60 +404,87 @@ SolveEfgLcp<T>::AllLemke(const BehavSupport &p_support,
   return 1;
 }
 
+//
+// Numbers the sequences of each player: the sequences of the actions
+// at the reachable infosets are numbered consecutively, in the order
+// of the infosets, following the empty sequence.
+//
+template <class T>
+void SolveEfgLcp<T>::IndexSequences(const BehavSupport &p_support)
+{
+  m_infosetIndex = Array<Array<int> >(2);
+  m_sequenceOffset = Array<Array<int> >(2);
+
+  for (int pl = 1; pl <= 2; pl++) {
+    int numInfosets = p_support.GetGame()->GetPlayer(pl)->NumInfosets();
+    m_infosetIndex[pl] = Array<int>(numInfosets);
+    m_sequenceOffset[pl] = Array<int>(numInfosets);
+    for (int iset = 1; iset <= numInfosets; iset++) {
+      m_infosetIndex[pl][iset] = 0;
+      m_sequenceOffset[pl][iset] = 0;
+    }
+
+    const List<GameInfoset> &isets = (pl == 1) ? isets1 : isets2;
+    int offset = 1;
+    for (int i = 1; i <= isets.Length(); i++) {
+      int iset = isets[i]->GetNumber();
+      m_infosetIndex[pl][iset] = i;
+      m_sequenceOffset[pl][iset] = offset;
+      offset += p_support.NumActions(pl, iset);
+    }
+  }
+}
+
+//
+// Writes the payoff and constraint entries of the sequence form in a
+// single sweep of the tree.  s1 and s2 are the sequences of the players
+// leading to the node.
+//
 template <class T>
-void SolveEfgLcp<T>::FillTableau(const BehavSupport &p_support, Matrix<T> &A,
-				 const GameNode &n, T prob,
-				 int s1, int s2, int i1, int i2)
+void SolveEfgLcp<T>::FillTableau(const BehavSupport &p_support,
+				 SparseMatrix<T> &A,
+				 const GameNode &n, T prob, int s1, int s2)
 {
-  int snew;
   GameOutcome outcome = n->GetOutcome();
   if (outcome) {
-    A(s1,ns1+s2) = Rational(A(s1,ns1+s2)) +
-      Rational(prob) * (outcome->GetPayoff<Rational>(1) - Rational(maxpay));
-    A(ns1+s2,s1) = Rational(A(ns1+s2,s1)) +
-      Rational(prob) * (outcome->GetPayoff<Rational>(2) - Rational(maxpay));
+    A.Add(s1, ns1+s2,
+	  prob * (outcome->GetPayoff<T>(1) - maxpay));
+    A.Add(ns1+s2, s1,
+	  prob * (outcome->GetPayoff<T>(2) - maxpay));
   }
-  if (n->GetInfoset()) {
-    if (n->GetPlayer()->IsChance()) {
-      GameInfoset infoset = n->GetInfoset();
-      for (int i = 1; i <= n->NumChildren(); i++) {
-	FillTableau(p_support, A, n->GetChild(i),
-		    Rational(prob) * infoset->GetActionProb(i, Rational(0)),
-		    s1,s2,i1,i2);
-      }
+  if (!n->GetInfoset())  return;
+
+  GameInfoset infoset = n->GetInfoset();
+  if (n->GetPlayer()->IsChance()) {
+    for (int i = 1; i <= n->NumChildren(); i++) {
+      FillTableau(p_support, A, n->GetChild(i),
+		  prob * infoset->GetActionProb(i, (T) 0), s1, s2);
     }
-    int pl = n->GetPlayer()->GetNumber();
-    if (pl==1) {
-      i1=isets1.Find(n->GetInfoset());
-      snew=1;
-      for (int i = 1; i < i1; i++) {
-	snew+=p_support.NumActions(isets1[i]->GetPlayer()->GetNumber(),
-				   isets1[i]->GetNumber());
-      }
-      A(s1,ns1+ns2+i1+1) = -(T)1;
-      A(ns1+ns2+i1+1,s1) = (T)1;
-      for (int i = 1; i <= p_support.NumActions(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber()); i++) {
-	A(snew+i,ns1+ns2+i1+1) = (T)1;
-	A(ns1+ns2+i1+1,snew+i) = -(T)1;
-	FillTableau(p_support, A, n->GetChild(p_support.GetAction(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber(), i)->GetNumber()),prob,snew+i,s2,i1,i2);
-      }
+    return;
+  }
+
+  int pl = n->GetPlayer()->GetNumber();
+  if (pl != 1 && pl != 2)  return;
+
+  int iset = infoset->GetNumber();
+  int snew = m_sequenceOffset[pl][iset];
+  int row = (pl == 1) ? ns1+ns2+m_infosetIndex[pl][iset]+1 :
+    ns1+ns2+ni1+m_infosetIndex[pl][iset]+1;
+  int s = (pl == 1) ? s1 : ns1+s2;
+  int first = (pl == 1) ? 0 : ns1;
+  A.Set(s, row, -(T)1);
+  A.Set(row, s, (T)1);
+
+  for (int i = 1; i <= p_support.NumActions(pl, iset); i++) {
+    A.Set(first+snew+i, row, (T)1);
+    A.Set(row, first+snew+i, -(T)1);
+    GameNode child = n->GetChild(p_support.GetAction(pl, iset, i)->GetNumber());
+    if (pl == 1) {
+      FillTableau(p_support, A, child, prob, snew+i, s2);
     }
-    if(pl==2) {
-      i2=isets2.Find(n->GetInfoset());
-      snew=1;
-      for (int i = 1; i < i2; i++) {
-	snew+=p_support.NumActions(isets2[i]->GetPlayer()->GetNumber(),
-				   isets2[i]->GetNumber());
-      }
-      A(ns1+s2,ns1+ns2+ni1+i2+1) = -(T)1;
-      A(ns1+ns2+ni1+i2+1,ns1+s2) = (T)1;
-      for (int i = 1; i <= p_support.NumActions(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber()); i++) {
-	A(ns1+snew+i,ns1+ns2+ni1+i2+1) = (T)1;
-	A(ns1+ns2+ni1+i2+1,ns1+snew+i) = -(T)1;
-	FillTableau(p_support, A, n->GetChild(p_support.GetAction(n->GetInfoset()->GetPlayer()->GetNumber(), n->GetInfoset()->GetNumber(), i)->GetNumber()),prob,s1,snew+i,i1,i2);
-      }
+    else {
+      FillTableau(p_support, A, child, prob, s1, snew+i);
     }
-    
   }
 }
 
@@ -473,11 +506,8 @@ void SolveEfgLcp<T>::GetProfile(const BehavSupport &p_support,
       }
     }
     else if (pl == 1) {
-      int inf = isets1.Find(n->GetInfoset());
-      int snew = 1;
-      for (int i = 1; i < inf; i++) {
-	snew += p_support.NumActions(1, isets1[i]->GetNumber()); 
-      }
+      int inf = m_infosetIndex[pl][iset];
+      int snew = m_sequenceOffset[pl][iset];
       
       for (int i = 1; i <= p_support.NumActions(pl, iset); i++) {
 	v(pl,inf,i) = (T) 0;
@@ -498,11 +528,8 @@ void SolveEfgLcp<T>::GetProfile(const BehavSupport &p_support,
       }
     }
     else if (pl == 2) { 
-      int inf = isets2.Find(n->GetInfoset());
-      int snew = 1;
-      for (int i = 1; i < inf; i++) {
-	snew += p_support.NumActions(2, isets2[i]->GetNumber()); 
-      }
+      int inf = m_infosetIndex[pl][iset];
+      int snew = m_sequenceOffset[pl][iset];
 
       for (int i = 1; i<= p_support.NumActions(pl, iset); i++) {
 	v(pl,inf,i) = (T) 0;
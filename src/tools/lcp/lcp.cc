@@ -60,6 +60,7 @@ void PrintHelp(char *progname)
   std::cerr << "  -D               print detailed information about equilibria\n";
   std::cerr << "  -h               print this help message\n";
   std::cerr << "  -q               quiet mode (suppresses banner)\n";
+  std::cerr << "  -t THREADS       number of threads (default 1; 0 for one per processor)\n";
   exit(1);
 }
 
@@ -67,6 +68,7 @@ int g_numDecimals = 6;
 bool g_printDetail = false;
 int g_stopAfter = 0;
 int g_maxDepth = 0;
+int g_numThreads = 1;
 
 extern void PrintProfile(std::ostream &, const std::string &,
 			 const MixedBehavProfile<double> &);
@@ -79,7 +81,7 @@ int main(int argc, char *argv[])
   int c;
   bool useFloat = false, useStrategic = false, bySubgames = false, quiet = false;
 
-  while ((c = getopt(argc, argv, "d:DhqSPe:r:")) != -1) {
+  while ((c = getopt(argc, argv, "d:DhqSPe:r:t:")) != -1) {
     switch (c) {
     case 'd':
       useFloat = true;
@@ -106,6 +108,9 @@ int main(int argc, char *argv[])
     case 'P':
       bySubgames = true;
       break;
+    case 't':
+      g_numThreads = atoi(optarg);
+      break;
     case '?':
       if (isprint(optopt)) {
 	std::cerr << argv[0] << ": Unknown option `-" << ((char) optopt) << "'.\n";
@@ -171,8 +176,8 @@ int main(int argc, char *argv[])
     }
     return 0;
   }
-  catch (InvalidFileException) {
-    std::cerr << "Error: Game not in a recognized format.\n";
+  catch (InvalidFileException &e) {
+    std::cerr << "Error: " << e.what() << ".\n";
     return 1;
   }
   catch (...) {
@@ -25,11 +25,12 @@
 #include <iostream>
 
 #include "libgambit/libgambit.h"
+#include "libgambit/workpool.h"
 #include "lhtab.h"
 
 using namespace Gambit;
 
-extern int g_numDecimals, g_stopAfter, g_maxDepth;
+extern int g_numDecimals, g_stopAfter, g_maxDepth, g_numThreads;
 extern bool g_printDetail;
 
 namespace {
@@ -185,6 +186,37 @@ bool OnBFS(const StrategySupport &p_support,
   return true;
 }
 
+//
+// Follows the Lemke-Howson path dropping a label, starting from a copy
+// of a tableau.  The tableau reached is kept only if its CBFS is not
+// in the list of those already found, which must not change while the
+// task may run.
+//
+template <class T> class LemkePathTask : public WorkTask {
+private:
+  const LHTableau<T> &m_start;
+  const List<BFS<T> > &m_list;
+
+public:
+  int m_label;
+  LHTableau<T> *m_tableau;
+
+  LemkePathTask(const LHTableau<T> &p_start, int p_label,
+		const List<BFS<T> > &p_list)
+    : m_start(p_start), m_list(p_list), m_label(p_label), m_tableau(0) { }
+  virtual ~LemkePathTask() { if (m_tableau)  delete m_tableau; }
+
+  void Run(void)
+  {
+    m_tableau = new LHTableau<T>(m_start);
+    m_tableau->LemkePath(m_label);
+    if (m_list.Contains(m_tableau->GetBFS())) {
+      delete m_tableau;
+      m_tableau = 0;
+    }
+  }
+};
+
 //
 // AllLemke finds all accessible Nash equilibria by recursively 
 // calling itself.  p_list maintains the list of basic variables 
@@ -192,10 +224,15 @@ bool OnBFS(const StrategySupport &p_support,
 // From each new accessible equilibrium, it follows
 // all possible paths, adding any new equilibria to the List.  
 //
+// The paths from an equilibrium are followed concurrently, and the
+// equilibria they reach are then visited in the order of the labels
+// dropped, so the equilibria are found in the same order whatever the
+// number of threads.
+//
 template <class T> void AllLemke(const StrategySupport &p_support,
 				 int j, LHTableau<T> &B,
 				 List<BFS<T> > &p_list,
-				 int depth)
+				 int depth, WorkPool &p_pool)
 {
   if (g_maxDepth != 0 && depth > g_maxDepth) {
     return;
@@ -206,13 +243,36 @@ template <class T> void AllLemke(const StrategySupport &p_support,
   if (depth > 0 && !OnBFS(p_support, p_list, B)) {
     return;
   }
-  
-  for (int i = B.MinCol(); i <= B.MaxCol(); i++) {
-    if (i != j)  {
-      LHTableau<T> Bcopy(B);
-      Bcopy.LemkePath(i);
-      AllLemke(p_support, i, Bcopy, p_list, depth+1);
+
+  if (g_maxDepth != 0 && depth + 1 > g_maxDepth) {
+    return;
+  }
+
+  std::vector<LemkePathTask<T> *> tasks;
+  try {
+    WorkGroup group(p_pool);
+    for (int i = B.MinCol(); i <= B.MaxCol(); i++) {
+      if (i != j)  {
+	tasks.push_back(new LemkePathTask<T>(B, i, p_list));
+	group.Submit(tasks.back());
+      }
     }
+    group.Wait();
+
+    for (size_t k = 0; k < tasks.size(); k++) {
+      if (tasks[k]->m_tableau) {
+	AllLemke(p_support, tasks[k]->m_label, *tasks[k]->m_tableau,
+		 p_list, depth+1, p_pool);
+      }
+      delete tasks[k];
+      tasks[k] = 0;
+    }
+  }
+  catch (...) {
+    for (size_t k = 0; k < tasks.size(); k++) {
+      if (tasks[k])  delete tasks[k];
+    }
+    throw;
   }
 }
 
@@ -231,7 +291,8 @@ void SolveStrategic(const Game &p_game)
 
     if (g_stopAfter != 1) {
       try {
-	AllLemke(support, 0, B, bfsList, 0);
+	WorkPool pool(g_numThreads);
+	AllLemke(support, 0, B, bfsList, 0, pool);
       }
       catch (EquilibriumLimitReachedNfg &) {
 	// This pseudo-exception requires no additional action;
@@ -72,7 +72,7 @@ double EFLiapFunc::Value(const Gambit::Vector<double> &v) const
 {
   _nevals++;
   ((Gambit::Vector<double> &) _p).operator=(v);
-    //_p = v;
+  _p.Invalidate();
   return _p.GetLiapValue();
 }
 
@@ -105,6 +105,9 @@ bool EFLiapFunc::Gradient(const Gambit::Vector<double> &x,
   const double DELTA = .00001;
 
   ((Gambit::Vector<double> &) _p).operator=(x);
+  _p.Invalidate();
+  // Each step changes one information set, so the profile's cached
+  // values are updated rather than recomputed
   for (int i = 1; i <= x.Length(); i++) {
     _p[i] += DELTA;
     double value = _p.GetLiapValue();
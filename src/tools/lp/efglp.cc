@@ -24,7 +24,7 @@
 #include <unistd.h>
 #include <iostream>
 #include "libgambit/libgambit.h"
-#include "liblinear/lpsolve.h"
+#include "liblinear/sparselp.h"
 
 using namespace Gambit;
 
@@ -53,13 +53,13 @@ struct GameData {
 template <class T>
 void BuildConstraintMatrix(GameData &p_data,
 			   const BehavSupport &p_support,
-			   Matrix<T> &A, const GameNode &n, const T &prob,
+			   SparseMatrix<T> &A, const GameNode &n, const T &prob,
 			   int s1, int s2, int i1, int i2)
 {
   GameOutcome outcome = n->GetOutcome();
   if (outcome) {
-    A(s1,s2) += 
-      (T) (Rational(prob) * outcome->GetPayoff<Rational>(1) - p_data.minpay);
+    A.Add(s1, s2,
+	  (T) (Rational(prob) * outcome->GetPayoff<Rational>(1) - p_data.minpay));
   }
 
   if (n->NumChildren() == 0) {
@@ -78,9 +78,9 @@ void BuildConstraintMatrix(GameData &p_data,
   else if (n->GetPlayer()->GetNumber() == 1) {
     i1 = p_data.infosetIndex(1, n->GetInfoset()->GetNumber());
     int snew = p_data.infosetOffset(1, n->GetInfoset()->GetNumber());
-    A(s1, p_data.ns2+i1+1) = (T) 1;
+    A.Set(s1, p_data.ns2+i1+1, (T) 1);
     for (int i = 1; i <= p_support.NumActions(n->GetInfoset()); i++) {
-      A(snew+i, p_data.ns2+i1+1) = (T) -1;
+      A.Set(snew+i, p_data.ns2+i1+1, (T) -1);
       BuildConstraintMatrix(p_data, p_support, A, 
 			    n->GetChild(p_support.GetAction(n->GetInfoset(), i)->GetNumber()),
 			    prob, snew+i, s2, i1, i2);
@@ -89,9 +89,9 @@ void BuildConstraintMatrix(GameData &p_data,
   else {  // Must be player 2
     i2 = p_data.infosetIndex(2, n->GetInfoset()->GetNumber());
     int snew = p_data.infosetOffset(2, n->GetInfoset()->GetNumber());
-    A(p_data.ns1+i2+1, s2) = (T) -1;
+    A.Set(p_data.ns1+i2+1, s2, (T) -1);
     for (int i = 1; i <= p_support.NumActions(n->GetInfoset()); i++) {
-      A(p_data.ns1+i2+1, snew+i) = (T) 1;
+      A.Set(p_data.ns1+i2+1, snew+i, (T) 1);
       BuildConstraintMatrix(p_data, p_support, A, 
 			    n->GetChild(p_support.GetAction(n->GetInfoset(), i)->GetNumber()),
 			    prob, s1, snew+i, i1, i2);
@@ -162,16 +162,16 @@ void PrintCPLEX(std::ostream &p_stream,
 // replace this function.
 //
 template <class T> bool
-SolveLP(const Matrix<T> &A, const Vector<T> &b, const Vector<T> &c,
+SolveLP(const SparseMatrix<T> &A, const Vector<T> &b, const Vector<T> &c,
 	int nequals,
 	Array<T> &p_primal, Array<T> &p_dual)
 {
-  LPSolve<T> LP(A, b, c, nequals);
-  if (!LP.IsAborted()) {
+  SparseLPSolve<T> LP(A, b, c, nequals);
+  if (LP.IsFeasible() && LP.IsBounded()) {
     BFS<T> cbfs;
     LP.OptBFS(cbfs);
 
-    for (int i = 1; i <= A.NumColumns(); i++) {
+    for (int i = 1; i <= c.Length(); i++) {
       if (cbfs.count(i)) {
 	p_primal[i] = cbfs[i];
       }
@@ -180,7 +180,7 @@ SolveLP(const Matrix<T> &A, const Vector<T> &b, const Vector<T> &c,
       }
     }
 
-    for (int i = 1; i <= A.NumRows(); i++) {
+    for (int i = 1; i <= b.Length(); i++) {
       if (cbfs.count(-i)) {
 	p_dual[i] = cbfs[-i];
       }
@@ -446,23 +446,22 @@ void SolveExtensive(const Game &p_game)
   }
   data.minpay = p_game->GetMinPayoff();
 
-  Matrix<T> A(1, data.ns1 + data.ni2, 1, data.ns2 + data.ni1);
+  SparseMatrix<T> A(1, data.ns1 + data.ni2, 1, data.ns2 + data.ni1);
   Vector<T> b(1, data.ns1 + data.ni2);
   Vector<T> c(1, data.ns2 + data.ni1);
 
-  A = (T) 0;
   b = (T) 0;
   c = (T) 0;
 
   BuildConstraintMatrix(data, support, A, p_game->GetRoot(), 
 			(T) 1, 1, 1, 0, 0);
-  A(1, data.ns2 + 1) = (T) -1;
-  A(data.ns1 + 1, 1) = (T) 1;
+  A.Set(1, data.ns2 + 1, (T) -1);
+  A.Set(data.ns1 + 1, 1, (T) 1);
 
   b[data.ns1 + 1] = (T) 1;
   c[data.ns2 + 1] = (T) -1;
 
-  Array<T> primal(A.NumColumns()), dual(A.NumRows());
+  Array<T> primal(c.Length()), dual(b.Length());
   if (SolveLP(A, b, c, data.ni2, primal, dual)) {
     SequenceToBehavior(data, support, primal, dual);
   }